@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <type_traits>
 #include <tuple>
+#include <utility>
 
 #include "is_reference_wrapper.hpp"
 #include "invoke.hpp"
+#include "meta_index_of.hpp"
 
 template<class TDi,
     bool = is_reference_wrapper_v<TDi>,
@@ -17,6 +22,10 @@ struct BoundArgument {
     using type = TDi&;
     template<class...>
     using const_type = TDi const&;
+    template<class...>
+    using rvalue_type = TDi&&;
+    template<class...>
+    using const_rvalue_type = TDi const&&;
 };
 
 template<class TDi>
@@ -26,6 +35,10 @@ struct BoundArgument<TDi, true, false, false> {
     using type = typename TDi::type&;
     template<class...>
     using const_type = typename TDi::type&;
+    template<class...>
+    using rvalue_type = typename TDi::type&;
+    template<class...>
+    using const_rvalue_type = typename TDi::type&;
 };
 
 template<class TDi>
@@ -35,6 +48,10 @@ struct BoundArgument<TDi, false, true, false> {
     using type = std::invoke_result_t<TDi&, U&&...>;
     template<class... U>
     using const_type = std::invoke_result_t<TDi const&, U&&...>;
+    template<class... U>
+    using rvalue_type = std::invoke_result_t<TDi&&, U&&...>;
+    template<class... U>
+    using const_rvalue_type = std::invoke_result_t<TDi const&&, U&&...>;
 };
 
 template<class TDi>
@@ -44,42 +61,184 @@ struct BoundArgument<TDi, false, false, true> {
     using type = std::tuple_element_t<position - 1, std::tuple<U...>>;
     template<class... U>
     using const_type = std::tuple_element_t<position - 1, std::tuple<U...>>;
+    template<class... U>
+    using rvalue_type = std::tuple_element_t<position - 1, std::tuple<U...>>;
+    template<class... U>
+    using const_rvalue_type = std::tuple_element_t<position - 1, std::tuple<U...>>;
+};
+
+// A bound argument that needs no storage: an empty placeholder, which
+// transform_args only looks at the type of.
+template<class T>
+inline constexpr bool bind_stateless_v = std::is_placeholder_v<T> > 0 &&
+    std::is_empty_v<T> && std::is_trivially_default_constructible_v<T>;
+
+template<class T>
+inline constexpr T bind_stateless{};
+
+// The Ith bound argument of a Bind, which is an empty class if T is.
+template<std::size_t I, class T>
+struct bind_leaf {
+    [[no_unique_address]] T value;
 };
 
+template<class... Ts>
+inline constexpr std::size_t bind_stored_count =
+    (std::size_t(!bind_stateless_v<Ts>) + ... + 0);
+
+// The indices of the bound arguments Ts... that are stored, from the most
+// to the least aligned, and in order among equally aligned types, so that
+// their leaves follow one another with no padding between them. Empty
+// types come first: their leaves overlap the others, and g++ 12 gets the
+// value of a leaf wrong when the constructor is constant-evaluated and an
+// empty leaf that overlaps it is initialized after it.
+template<class... Ts>
+constexpr std::array<std::size_t, bind_stored_count<Ts...>> bind_args_order() {
+    constexpr std::array<std::size_t, sizeof...(Ts)> aligns{
+        (std::is_empty_v<Ts> ? std::size_t(-1) : alignof(Ts))... };
+    constexpr std::array<bool, sizeof...(Ts)> stored{ !bind_stateless_v<Ts>... };
+    std::array<std::size_t, bind_stored_count<Ts...>> order{};
+    std::size_t n = 0;
+    for (std::size_t i = 0; i != sizeof...(Ts); ++i) {
+        if (!stored[i])
+            continue;
+        auto j = n++;
+        for (; j != 0 && aligns[order[j - 1]] < aligns[i]; --j)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+    return order;
+}
+
+template<class... Ts, std::size_t... Ks>
+auto bind_args_sequence(std::index_sequence<Ks...>)
+    -> std::index_sequence<bind_args_order<Ts...>()[Ks]...>;
+
+// The size of the stored bound arguments Ts... when packed with no padding.
+// It is exact unless one of them is an empty class: an empty class that
+// is bound twice, or that is also a member of another bound argument, takes
+// space to keep its two objects at distinct addresses.
+template<class... Ts>
+constexpr std::size_t bind_args_size() {
+    std::size_t size = 0, align = 1;
+    ((std::is_empty_v<Ts> ? void() :
+        void((size += sizeof(Ts), align = std::max(align, alignof(Ts))))), ...);
+    return std::max<std::size_t>((size + align - 1) / align * align, 1);
+}
+
+template<class Order, class... Ts>
+struct bind_args_impl;
+
+template<std::size_t... Ps, class... Ts>
+struct bind_args_impl<std::index_sequence<Ps...>, Ts...>
+    : bind_leaf<Ps, std::tuple_element_t<Ps, std::tuple<Ts...>>>...
+{
+    template<class... Args>
+    constexpr explicit bind_args_impl([[maybe_unused]] std::tuple<Args...> args)
+        : bind_leaf<Ps, std::tuple_element_t<Ps, std::tuple<Ts...>>>{
+            std::get<Ps>(std::move(args)) }...
+    {}
+};
+
+// The bound arguments of a Bind, which replace a std::tuple<Ts...> to take
+// less space: the leaves are in the order of bind_args_order, and
+// placeholders are not stored at all. Being trivially
+// copyable when Ts... are, unlike std::tuple, also lets a std::function
+// keep a small Bind in its local buffer rather than on the heap. The
+// arguments are accessed with bind_get<I>, I being the position they were
+// bound at.
+template<class... Ts>
+struct bind_args
+    : bind_args_impl<decltype(bind_args_sequence<Ts...>(
+        std::make_index_sequence<bind_stored_count<Ts...>>{})), Ts...>
+{
+    template<class... Args>
+    requires (sizeof...(Args) == sizeof...(Ts))
+    constexpr bind_args(std::in_place_t, Args&&... args)
+        : bind_args::bind_args_impl(std::forward_as_tuple(std::forward<Args>(args)...))
+    {
+        static_assert(((std::is_empty_v<Ts> && !bind_stateless_v<Ts>) || ...) ||
+            sizeof(bind_args) <= bind_args_size<Ts...>(),
+            "Bound arguments are not packed.");
+    }
+};
+
+template<std::size_t I, class... Ts>
+constexpr auto& bind_get(bind_args<Ts...>& args) noexcept {
+    using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+    if constexpr (bind_stateless_v<T>)
+        return bind_stateless<T>;
+    else
+        return static_cast<bind_leaf<I, T>&>(args).value;
+}
+template<std::size_t I, class... Ts>
+constexpr auto& bind_get(const bind_args<Ts...>& args) noexcept {
+    using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+    if constexpr (bind_stateless_v<T>)
+        return bind_stateless<T>;
+    else
+        return static_cast<const bind_leaf<I, T>&>(args).value;
+}
+template<std::size_t I, class... Ts>
+constexpr auto&& bind_get(bind_args<Ts...>&& args) noexcept {
+    using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+    if constexpr (bind_stateless_v<T>)
+        return bind_stateless<T>;
+    else
+        return static_cast<bind_leaf<I, T>&&>(args).value;
+}
+template<std::size_t I, class... Ts>
+constexpr auto&& bind_get(const bind_args<Ts...>&& args) noexcept {
+    using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+    if constexpr (bind_stateless_v<T>)
+        return bind_stateless<T>;
+    else
+        return static_cast<const bind_leaf<I, T>&&>(args).value;
+}
+
 template<class FD, class R, class... BoundArgs>
 struct Bind {
-    FD fd;
-    std::tuple<BoundArgs...> bound_args;
+    // The bound arguments come first so that fd can fill their tail padding.
+    [[no_unique_address]] bind_args<BoundArgs...> bound_args;
+    [[no_unique_address]] FD fd;
 private:
+    template<class>
+    friend struct BindFused;
+
+    // A bound argument is passed with the value category of the Bind:
+    // moved from by a call on an rvalue, except for a reference_wrapper,
+    // which is always unwrapped to an lvalue.
     template<class cvTDi, class... U>
-    static constexpr decltype(auto) transform_args(cvTDi& tdi, U&&... u) {
+    static constexpr decltype(auto) transform_args(cvTDi&& tdi, U&&... u) {
         using TDi = std::remove_cvref_t<cvTDi>;
         if constexpr (is_reference_wrapper_v<TDi>)
             return tdi.get();
         else if constexpr (std::is_bind_expression_v<TDi>)
-            return tdi(std::forward<U>(u)...);
+            return std::forward<cvTDi>(tdi)(std::forward<U>(u)...);
         else if constexpr ((std::is_placeholder_v<TDi>) > 0) {
             constexpr std::size_t position = std::is_placeholder_v<TDi>;
             return std::get<position - 1>(std::forward_as_tuple(std::forward<U>(u)...));
         } else
-            return tdi;
+            return std::forward<cvTDi>(tdi);
     }
 
     template<class cvFD, class BoundArgTpl, class... UnBoundArgs, std::size_t... idx>
-    static constexpr decltype(auto) call(cvFD& fd,
-        /* cv std::tuple<TDi...>& */ BoundArgTpl& bound_args, std::index_sequence<idx...>,
+    static constexpr decltype(auto) call(cvFD&& fd,
+        /* cv bind_args<TDi...>&[&] */ BoundArgTpl&& bound_args, std::index_sequence<idx...>,
         UnBoundArgs&&... unbound_args
     ) {
         if constexpr (std::is_same_v<R, void(void)>)
-            return (invoke)(fd, transform_args(std::get<idx>(bound_args),
+            return (invoke)(std::forward<cvFD>(fd), transform_args(
+                bind_get<idx>(std::forward<BoundArgTpl>(bound_args)),
                 std::forward<UnBoundArgs>(unbound_args)...)...);
         else
-            return (invoke<R>)(fd, transform_args(std::get<idx>(bound_args),
+            return (invoke<R>)(std::forward<cvFD>(fd), transform_args(
+                bind_get<idx>(std::forward<BoundArgTpl>(bound_args)),
                 std::forward<UnBoundArgs>(unbound_args)...)...);
     }
 public:
     template<class... UnBoundArgs>
-    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) {
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) & {
         static_assert(
             std::is_invocable_v<
                 FD&, typename BoundArgument<BoundArgs>::template type<UnBoundArgs&&...>...
@@ -91,7 +250,7 @@ public:
     }
 
     template<class... UnBoundArgs>
-    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) const {
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) const& {
         static_assert(
             std::is_invocable_v<
                 FD const&, typename BoundArgument<BoundArgs>::template const_type<UnBoundArgs&&...>...
@@ -101,25 +260,373 @@ public:
         return (call)(fd, bound_args, std::index_sequence_for<BoundArgs...>{},
             std::forward<UnBoundArgs>(unbound_args)...);
     }
+
+    template<class... UnBoundArgs>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) && {
+        static_assert(
+            std::is_invocable_v<
+                FD&&, typename BoundArgument<BoundArgs>::template rvalue_type<UnBoundArgs&&...>...
+            >,
+            "The target object is not callable with the given arguments."
+        );
+        return (call)(std::move(fd), std::move(bound_args), std::index_sequence_for<BoundArgs...>{},
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
+
+    template<class... UnBoundArgs>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) const&& {
+        static_assert(
+            std::is_invocable_v<
+                FD const&&, typename BoundArgument<BoundArgs>::template const_rvalue_type<UnBoundArgs&&...>...
+            >,
+            "The target object is not callable with the given arguments."
+        );
+        return (call)(std::move(fd), std::move(bound_args), std::index_sequence_for<BoundArgs...>{},
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
 };
 
+// The Bind of bind_once, which moves its target object and bound arguments
+// into the call even when called as an lvalue, e.g. through a
+// std::function, so that a callback can hand its buffers over to the
+// target without copying them. It is meant to be called once: a second
+// call sees moved-from arguments.
+template<class FD, class R, class... BoundArgs>
+struct BindOnce : Bind<FD, R, BoundArgs...> {
+    template<class... UnBoundArgs>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) {
+        return static_cast<Bind<FD, R, BoundArgs...>&&>(*this)(
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
+};
+
+template<class B>
+struct BindFused;
+
 namespace std {
     template<class FD, class R, class... BoundArgs>
     struct is_bind_expression<Bind<FD, R, BoundArgs...>> : true_type {};
     template<class FD, class R, class... BoundArgs>
     struct is_bind_expression<const Bind<FD, R, BoundArgs...>> : true_type {};
+    template<class FD, class R, class... BoundArgs>
+    struct is_bind_expression<BindOnce<FD, R, BoundArgs...>> : true_type {};
+    template<class FD, class R, class... BoundArgs>
+    struct is_bind_expression<const BindOnce<FD, R, BoundArgs...>> : true_type {};
+    template<class B>
+    struct is_bind_expression<BindFused<B>> : true_type {};
+    template<class B>
+    struct is_bind_expression<const BindFused<B>> : true_type {};
 }
 
 template<class F, class... BoundArgs>
 constexpr Bind<std::decay_t<F>, void(void), std::decay_t<BoundArgs>...>
     bind(F&& f, BoundArgs&&... bound_args)
 {
-    return { std::forward<F>(f), { std::forward<BoundArgs>(bound_args)... } };
+    return { { std::in_place, std::forward<BoundArgs>(bound_args)... }, std::forward<F>(f) };
 }
 
 template<class R, class F, class... BoundArgs>
 constexpr Bind<std::decay_t<F>, R, std::decay_t<BoundArgs>...>
     bind(F&& f, BoundArgs&&... bound_args)
 {
-    return { std::forward<F>(f), { std::forward<BoundArgs>(bound_args)... } };
+    return { { std::in_place, std::forward<BoundArgs>(bound_args)... }, std::forward<F>(f) };
+}
+
+template<class F, class... BoundArgs>
+constexpr BindOnce<std::decay_t<F>, void(void), std::decay_t<BoundArgs>...>
+    bind_once(F&& f, BoundArgs&&... bound_args)
+{
+    return { { { std::in_place, std::forward<BoundArgs>(bound_args)... }, std::forward<F>(f) } };
+}
+
+template<class R, class F, class... BoundArgs>
+constexpr BindOnce<std::decay_t<F>, R, std::decay_t<BoundArgs>...>
+    bind_once(F&& f, BoundArgs&&... bound_args)
+{
+    return { { { std::in_place, std::forward<BoundArgs>(bound_args)... }, std::forward<F>(f) } };
+}
+
+template<class... Ts>
+struct bind_list {};
+
+template<class... Lists>
+struct bind_concat {
+    using type = bind_list<>;
+};
+template<class... Ts>
+struct bind_concat<bind_list<Ts...>> {
+    using type = bind_list<Ts...>;
+};
+template<class... Ts, class... Us, class... Lists>
+struct bind_concat<bind_list<Ts...>, bind_list<Us...>, Lists...>
+    : bind_concat<bind_list<Ts..., Us...>, Lists...> {};
+
+template<class T, class List>
+inline constexpr std::size_t bind_list_count = 0;
+template<class T, class... Ts>
+inline constexpr std::size_t bind_list_count<T, bind_list<Ts...>> =
+    (std::size_t(std::is_same_v<T, Ts>) + ... + 0);
+
+template<class T>
+struct bind_traits {
+    static constexpr bool is_bind = false;
+};
+template<class FD, class R, class... BoundArgs>
+struct bind_traits<Bind<FD, R, BoundArgs...>> {
+    static constexpr bool is_bind = true;
+    using result = R;
+    static constexpr std::size_t arity = sizeof...(BoundArgs);
+};
+
+// The Binds of the tree of nested Binds rooted at T, children before their
+// parents, and T last; none if T is not a Bind.
+template<class T>
+struct bind_tree {
+    using type = bind_list<>;
+};
+template<class FD, class R, class... BoundArgs>
+struct bind_tree<Bind<FD, R, BoundArgs...>>
+    : bind_concat<typename bind_tree<BoundArgs>::type..., bind_list<Bind<FD, R, BoundArgs...>>> {};
+
+template<class T, class... Ts>
+constexpr std::size_t bind_first_index() {
+    std::size_t i = 0;
+    static_cast<void>(((std::is_same_v<T, Ts> ? false : (++i, true)) && ...));
+    return i;
+}
+
+// Whether T is a Bind that holds no state: its target object is an empty
+// class, and each bound argument a placeholder or such a Bind, so that all
+// objects of type T compute the same thing from the same call arguments.
+template<class T>
+inline constexpr bool bind_stateless_expr = false;
+template<class FD, class R, class... BoundArgs>
+inline constexpr bool bind_stateless_expr<Bind<FD, R, BoundArgs...>> =
+    std::is_empty_v<FD> &&
+    ((bind_stateless_v<BoundArgs> || bind_stateless_expr<BoundArgs>) && ...);
+
+// The types of the list of Binds Tree that occur more than once in it and
+// are bind_stateless_expr, in the order of their first occurrence.
+template<class Tree, class = void>
+struct bind_shared;
+template<class... Ts>
+struct bind_shared<bind_list<Ts...>, void>
+    : bind_shared<bind_list<Ts...>, std::index_sequence_for<Ts...>> {};
+template<class... Ts, std::size_t... Is>
+struct bind_shared<bind_list<Ts...>, std::index_sequence<Is...>>
+    : bind_concat<std::conditional_t<
+        bind_stateless_expr<Ts> && (bind_list_count<Ts, bind_list<Ts...>> > 1) && bind_first_index<Ts, Ts...>() == Is,
+        bind_list<Ts>, bind_list<>>...> {};
+
+// bind_fuse(b) returns a BindFused, which is called like b, but evaluates
+// the tree of Binds nested in b as one expression, computing each common
+// subexpression once per call: a nested Bind that occurs more than once in
+// the tree, and holds no state (an empty target object, and only
+// placeholders or such Binds as bound arguments), is called once, before
+// the rest of the tree, and its result passed to each place it occurs, as
+// an lvalue. The nested Binds must therefore not depend on being called
+// once per occurrence, e.g. for side effects. The other nested Binds, and
+// bind expressions other than Bind, are called as b would call them.
+template<class FD, class R, class... BoundArgs>
+struct BindFused<Bind<FD, R, BoundArgs...>> {
+    Bind<FD, R, BoundArgs...> expr;
+private:
+    using shared = typename bind_shared<typename bind_concat<
+        typename bind_tree<BoundArgs>::type...>::type>::type;
+
+    // The first Bind of type T in the tree rooted at node.
+    template<class T, class cvB>
+    static constexpr auto& find_(cvB& node) noexcept {
+        if constexpr (std::is_same_v<std::remove_const_t<cvB>, T>)
+            return node;
+        else
+            return (find_arg_<T>)(node, std::make_index_sequence<
+                bind_traits<std::remove_const_t<cvB>>::arity>{});
+    }
+    template<class T, class cvB, std::size_t I, std::size_t... Is>
+    static constexpr auto& find_arg_(cvB& node, std::index_sequence<I, Is...>) noexcept {
+        auto& arg = bind_get<I>(node.bound_args);
+        if constexpr (bind_list_count<T,
+                typename bind_tree<std::remove_cvref_t<decltype(arg)>>::type> != 0)
+            return (find_<T>)(arg);
+        else
+            return (find_arg_<T>)(node, std::index_sequence<Is...>{});
+    }
+
+    // The index of the result of the shared subexpression T in the memo.
+    template<class T, class... Ts>
+    static constexpr std::size_t index_(T*, bind_list<Ts...>) {
+        return meta_index_of<T, Ts...>::value;
+    }
+
+    template<class Memo, class cvTDi, class... U>
+    static constexpr decltype(auto) arg_(Memo& memo, cvTDi& tdi, U&&... u) {
+        using TDi = std::remove_const_t<cvTDi>;
+        if constexpr (bind_list_count<TDi, shared> != 0)
+            return std::get<(index_)(static_cast<TDi*>(nullptr), shared{})>(memo);
+        else if constexpr (bind_traits<TDi>::is_bind)
+            return (eval_)(memo, tdi, std::forward<U>(u)...);
+        else
+            return Bind<FD, R, BoundArgs...>::transform_args(tdi, std::forward<U>(u)...);
+    }
+
+    template<class Memo, class cvB, class... U, std::size_t... idx>
+    static constexpr decltype(auto) eval_(Memo& memo, cvB& node, std::index_sequence<idx...>,
+        U&&... u)
+    {
+        using R2 = typename bind_traits<std::remove_const_t<cvB>>::result;
+        if constexpr (std::is_same_v<R2, void(void)>)
+            return (invoke)(node.fd, (arg_)(memo, bind_get<idx>(node.bound_args),
+                std::forward<U>(u)...)...);
+        else
+            return (invoke<R2>)(node.fd, (arg_)(memo, bind_get<idx>(node.bound_args),
+                std::forward<U>(u)...)...);
+    }
+    template<class Memo, class cvB, class... U>
+    static constexpr decltype(auto) eval_(Memo& memo, cvB& node, U&&... u) {
+        return (eval_)(memo, node, std::make_index_sequence<
+            bind_traits<std::remove_const_t<cvB>>::arity>{}, std::forward<U>(u)...);
+    }
+
+    // Computes the shared subexpressions one after the other, each holding
+    // the results of the previous ones in memo, then the whole expression.
+    template<class cvRoot, class Memo, class... U>
+    static constexpr decltype(auto) run_(bind_list<>, cvRoot& root, Memo& memo, U&&... u) {
+        return (eval_)(memo, root, std::forward<U>(u)...);
+    }
+    template<class T, class... Ts, class cvRoot, class Memo, class... U>
+    static constexpr decltype(auto) run_(bind_list<T, Ts...>, cvRoot& root, Memo& memo,
+        U&&... u)
+    {
+        decltype(auto) value = (eval_)(memo, (find_<T>)(root), std::forward<U>(u)...);
+        auto next = std::tuple_cat(memo, std::tie(value));
+        return (run_)(bind_list<Ts...>{}, root, next, std::forward<U>(u)...);
+    }
+public:
+    template<class... UnBoundArgs>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) {
+        std::tuple<> memo;
+        return (run_)(shared{}, expr, memo, std::forward<UnBoundArgs>(unbound_args)...);
+    }
+
+    template<class... UnBoundArgs>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) const {
+        std::tuple<> memo;
+        return (run_)(shared{}, expr, memo, std::forward<UnBoundArgs>(unbound_args)...);
+    }
+};
+
+template<class FD, class R, class... BoundArgs>
+constexpr BindFused<Bind<FD, R, BoundArgs...>> bind_fuse(Bind<FD, R, BoundArgs...> b) {
+    return { std::move(b) };
+}
+
+// The result of bind_front<f> and bind_back<f>, which call f with the
+// bound arguments before or after the call arguments, like
+// std::bind_front and std::bind_back. The target object is a template
+// argument rather than a member, so only the bound arguments are stored,
+// and every call is a direct call to f, which the compiler can inline even
+// when f is a function pointer; a pointer to member is applied with .*.
+// Bound arguments are passed with the value category of the BindFixed, as
+// by Bind, but are never treated as placeholders or bind expressions.
+template<auto f, bool front, class... BoundArgs>
+struct BindFixed {
+    [[no_unique_address]] bind_args<BoundArgs...> bound_args;
+private:
+    template<class BoundArgTpl, class... UnBoundArgs>
+    static constexpr bool invocable = []<std::size_t... idx>(std::index_sequence<idx...>) {
+        if constexpr (front)
+            return std::is_invocable_v<decltype(f) const&,
+                decltype(bind_get<idx>(std::declval<BoundArgTpl>()))..., UnBoundArgs...>;
+        else
+            return std::is_invocable_v<decltype(f) const&,
+                UnBoundArgs..., decltype(bind_get<idx>(std::declval<BoundArgTpl>()))...>;
+    }(std::index_sequence_for<BoundArgs...>{});
+
+    // A pointer to member is applied to the object with .* on the constant
+    // f itself, rather than passed to invoke as a runtime argument.
+    template<class T, class... Args>
+    static constexpr decltype(auto) apply(T&& t, Args&&... args) {
+        if constexpr (std::is_member_function_pointer_v<decltype(f)>)
+            return ((invoke_impl<decltype(f)>::get)(std::forward<T>(t)).*f)(
+                std::forward<Args>(args)...);
+        else if constexpr (std::is_member_object_pointer_v<decltype(f)>)
+            return (invoke_impl<decltype(f)>::get)(std::forward<T>(t)).*f;
+        else
+            return (invoke)(f, std::forward<T>(t), std::forward<Args>(args)...);
+    }
+    static constexpr decltype(auto) apply() {
+        return (invoke)(f);
+    }
+
+    template<class BoundArgTpl, class... UnBoundArgs, std::size_t... idx>
+    static constexpr decltype(auto) call(
+        /* cv bind_args<TDi...>&[&] */ BoundArgTpl&& bound_args, std::index_sequence<idx...>,
+        UnBoundArgs&&... unbound_args
+    ) {
+        if constexpr (front)
+            return (apply)(bind_get<idx>(std::forward<BoundArgTpl>(bound_args))...,
+                std::forward<UnBoundArgs>(unbound_args)...);
+        else
+            return (apply)(std::forward<UnBoundArgs>(unbound_args)...,
+                bind_get<idx>(std::forward<BoundArgTpl>(bound_args))...);
+    }
+public:
+    template<class... UnBoundArgs>
+    requires invocable<bind_args<BoundArgs...>&, UnBoundArgs...>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) & {
+        return (call)(bound_args, std::index_sequence_for<BoundArgs...>{},
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
+
+    template<class... UnBoundArgs>
+    requires invocable<const bind_args<BoundArgs...>&, UnBoundArgs...>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) const& {
+        return (call)(bound_args, std::index_sequence_for<BoundArgs...>{},
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
+
+    template<class... UnBoundArgs>
+    requires invocable<bind_args<BoundArgs...>&&, UnBoundArgs...>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) && {
+        return (call)(std::move(bound_args), std::index_sequence_for<BoundArgs...>{},
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
+
+    template<class... UnBoundArgs>
+    requires invocable<const bind_args<BoundArgs...>&&, UnBoundArgs...>
+    constexpr decltype(auto) operator()(UnBoundArgs&&... unbound_args) const&& {
+        return (call)(std::move(bound_args), std::index_sequence_for<BoundArgs...>{},
+            std::forward<UnBoundArgs>(unbound_args)...);
+    }
+};
+
+template<auto f, class... BoundArgs>
+constexpr BindFixed<f, true, std::decay_t<BoundArgs>...>
+    bind_front(BoundArgs&&... bound_args)
+{
+    return { { std::in_place, std::forward<BoundArgs>(bound_args)... } };
 }
+
+template<auto f, class... BoundArgs>
+constexpr BindFixed<f, false, std::decay_t<BoundArgs>...>
+    bind_back(BoundArgs&&... bound_args)
+{
+    return { { std::in_place, std::forward<BoundArgs>(bound_args)... } };
+}
+
+// Placeholders and stateless target objects take no space, the other bound
+// arguments no padding, and a Bind of trivially copyable types is
+// trivially copyable.
+static_assert(sizeof(Bind<std::plus<>, void(void),
+    std::decay_t<decltype(std::placeholders::_1)>, int>) == sizeof(int));
+static_assert(sizeof(Bind<std::plus<>, void(void),
+    std::decay_t<decltype(std::placeholders::_2)>,
+    std::decay_t<decltype(std::placeholders::_1)>>) == 1);
+static_assert(sizeof(bind_args<char, double, char>) == 2 * sizeof(double));
+static_assert(sizeof(bind_args<std::plus<>, int, std::negate<>>) == sizeof(int));
+static_assert(std::is_empty_v<Bind<std::plus<>, void(void),
+    Bind<std::negate<>, void(void), std::decay_t<decltype(std::placeholders::_1)>>,
+    std::decay_t<decltype(std::placeholders::_1)>>>);
+static_assert(std::is_trivially_copyable_v<Bind<int(*)(int, int), void(void),
+    std::decay_t<decltype(std::placeholders::_1)>, int>>);
@@ -0,0 +1,515 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class T>
+    struct compact_niche;
+
+    template<class T>
+    struct compact_niche<T*>;
+
+    template<class... Ts>
+    class compact_variant {
+    public:
+        using index_type = ...;
+        static constexpr bool niche_packed;
+
+        constexpr compact_variant();
+        template<class T>
+        constexpr compact_variant(T&& v);
+        template<class T, class... Args>
+        constexpr explicit compact_variant(std::in_place_type_t<T>, Args&&... args);
+        template<std::size_t I, class... Args>
+        constexpr explicit compact_variant(std::in_place_index_t<I>, Args&&... args);
+
+        compact_variant(const compact_variant&);
+        compact_variant(compact_variant&&);
+        compact_variant& operator=(const compact_variant&);
+        compact_variant& operator=(compact_variant&&);
+        template<class T>
+        compact_variant& operator=(T&& v);
+        ~compact_variant();
+
+        template<std::size_t I, class... Args>
+        constexpr alternative_t<I>& emplace(Args&&... args);
+        template<class T, class... Args>
+        constexpr T& emplace(Args&&... args);
+
+        constexpr std::size_t index() const noexcept;
+        constexpr bool valueless_by_exception() const noexcept;
+        template<class T>
+        constexpr bool holds_alternative() const noexcept;
+    };
+
+    template<std::size_t I, class... Ts>
+    constexpr auto&& variant_get(compact_variant<Ts...>& v); // and const&, &&, const&&
+    template<class T, class... Ts>
+    constexpr auto&& variant_get(compact_variant<Ts...>& v); // and const&, &&, const&&
+
+    template<class... Ts>
+    struct std::variant_size<compact_variant<Ts...>>;
+    template<std::size_t I, class... Ts>
+    struct std::variant_alternative<I, compact_variant<Ts...>>;
+*/
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "meta_index_of.hpp"
+#include "variant_visit.hpp"
+
+// compact_niche<T> describes the niche of T: a byte of the object
+// representation of T, at offset, that no value of T sets to one of count
+// byte values, the niche values. value(k) is the kth niche value, for k <
+// count; holds(b) tells whether b is a niche value, and index(b) which one
+// it is. A compact_variant stores its index in the niche of its largest
+// alternative when there is one.
+// The primary template declares no niche. Users may specialize it for
+// their own types, e.g. for an enum that only takes a few values.
+template<class T>
+struct compact_niche {
+    static constexpr std::size_t count = 0;
+};
+
+// A pointer to a type aligned to 2^k has its k low bits clear, so a byte
+// with any of them set is never its low byte. On big-endian targets the low
+// byte is the last one, where it leaves no room for the other alternatives,
+// see compact_variant.
+template<class T>
+requires (alignof(T) > 1)
+struct compact_niche<T*> {
+    static constexpr std::size_t offset =
+        std::endian::native == std::endian::little ? 0 : sizeof(T*) - 1;
+    static constexpr std::size_t count = std::min<std::size_t>(alignof(T), 256) - 1;
+
+    static constexpr unsigned char value(std::size_t k) noexcept {
+        return static_cast<unsigned char>(k + 1);
+    }
+    static constexpr bool holds(unsigned char b) noexcept { return (b & count) != 0; }
+    static constexpr std::size_t index(unsigned char b) noexcept { return b - 1u; }
+};
+
+// The smallest unsigned type that can store the values 0 to n.
+template<std::size_t N>
+using compact_variant_index_t =
+    std::conditional_t<N <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+    std::conditional_t<N <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+        std::uint32_t>>;
+
+// An alternative of a compact_variant, placed after Head bytes; the niche
+// of the alternative that stores the index is among those bytes.
+template<std::size_t Head, class T>
+struct compact_variant_slot {
+    unsigned char head[Head];
+    T value;
+
+    template<class... Args>
+    constexpr explicit compact_variant_slot(std::in_place_t, Args&&... args)
+        : head(), value(static_cast<Args&&>(args)...) {}
+};
+template<class T>
+struct compact_variant_slot<0, T> {
+    T value;
+
+    template<class... Args>
+    constexpr explicit compact_variant_slot(std::in_place_t, Args&&... args)
+        : value(static_cast<Args&&>(args)...) {}
+};
+
+// The storage of a compact_variant: a union of its slots, built like
+// unsafe_optional_impl, whose destructor is defined only when it cannot be
+// trivial.
+template<std::size_t Raw, class... Slots>
+union compact_variant_union;
+
+template<std::size_t Raw>
+union compact_variant_union<Raw> {
+    unsigned char raw[Raw];
+
+    constexpr compact_variant_union() noexcept : raw() {}
+};
+
+template<std::size_t Raw, class Slot, class... Slots>
+union compact_variant_union<Raw, Slot, Slots...> {
+    unsigned char raw[Raw];
+    Slot head;
+    compact_variant_union<Raw, Slots...> tail;
+
+    constexpr compact_variant_union() noexcept : raw() {}
+    ~compact_variant_union() requires std::is_trivially_destructible_v<Slot> &&
+        std::is_trivially_destructible_v<compact_variant_union<Raw, Slots...>> = default;
+    ~compact_variant_union() {}
+};
+
+template<std::size_t I, class Union>
+constexpr auto& compact_variant_slot_of(Union& u) noexcept {
+    if constexpr (I == 0)
+        return u.head;
+    else
+        return (compact_variant_slot_of<I - 1>)(u.tail);
+}
+
+// The index of the alternative of Ts... whose niche can store the indices
+// of all the others, and the valueless state, with the others placed after
+// the niche and within its size and alignment; or sizeof...(Ts) if there is
+// none.
+template<class... Ts>
+constexpr std::size_t compact_variant_carrier() {
+    constexpr std::size_t n = sizeof...(Ts);
+    constexpr std::size_t sizes[] = { sizeof(Ts)... };
+    constexpr std::size_t aligns[] = { alignof(Ts)... };
+    constexpr std::size_t counts[] = { compact_niche<Ts>::count... };
+    constexpr std::size_t heads[] = { []{
+        if constexpr (compact_niche<Ts>::count != 0)
+            return compact_niche<Ts>::offset + 1;
+        else
+            return std::size_t(0);
+    }()... };
+    std::size_t max_size = 0, max_align = 0;
+    for (std::size_t i = 0; i != n; ++i) {
+        max_size = std::max(max_size, sizes[i]);
+        max_align = std::max(max_align, aligns[i]);
+    }
+    for (std::size_t c = 0; c != n; ++c) {
+        if (counts[c] < n || sizes[c] != max_size || aligns[c] != max_align)
+            continue;
+        bool fits = true;
+        for (std::size_t j = 0; j != n; ++j) {
+            const auto offset = (heads[c] + aligns[j] - 1) / aligns[j] * aligns[j];
+            if (j != c && offset + sizes[j] > sizes[c])
+                fits = false;
+        }
+        if (fits)
+            return c;
+    }
+    return n;
+}
+
+// A compact_variant<Ts...> holds one value of one of the distinct types
+// Ts..., like std::variant<Ts...>, in less space:
+//  - if one of the largest alternatives has a niche (see compact_niche)
+//    with room for the indices of all the others, the others are placed
+//    after the niche byte, which then stores their index, and the
+//    compact_variant is the size of that alternative, e.g. 8 bytes for
+//    compact_variant<int, float, int*> on a 64-bit little-endian target;
+//  - otherwise the index is stored in the smallest unsigned type that fits
+//    it, after the storage.
+// It is visited with variant_visit, through variant_get, and like
+// std::variant can become valueless if a constructor throws while it
+// changes the alternative.
+// The converting constructor and assignment take a value of exactly one of
+// Ts... (after removing references and cv-qualifiers), rather than choosing
+// an alternative by overload resolution. In the niche-packed layout index()
+// reads a byte of the storage, so it is not constexpr.
+template<class... Ts>
+class compact_variant {
+    static_assert(sizeof...(Ts) != 0, "compact_variant needs at least one type.");
+    static_assert((std::is_object_v<Ts> && ...) && (!std::is_array_v<Ts> && ...),
+        "Ts must be non-array object types.");
+
+    static constexpr std::size_t size_ = sizeof...(Ts);
+    static constexpr std::size_t carrier_ = compact_variant_carrier<Ts...>();
+public:
+    static constexpr bool niche_packed = carrier_ != size_;
+    using index_type = compact_variant_index_t<size_>;
+    template<std::size_t I>
+    using alternative_t = std::variant_alternative_t<I, std::variant<Ts...>>;
+private:
+    template<std::size_t I>
+    struct niche_;
+    template<std::size_t I>
+    requires (I < size_)
+    struct niche_<I> : compact_niche<alternative_t<I>> {};
+
+    static constexpr std::size_t head_ = [] {
+        if constexpr (niche_packed)
+            return niche_<carrier_>::offset + 1;
+        else
+            return std::size_t(0);
+    }();
+
+    template<class Is>
+    struct layout_;
+    template<std::size_t... Is>
+    struct layout_<std::index_sequence<Is...>> {
+        using type = compact_variant_union<(niche_packed ? head_ : 1),
+            compact_variant_slot<(Is == carrier_ ? 0 : head_), Ts>...>;
+    };
+
+    struct no_index {};
+
+    typename layout_<std::index_sequence_for<Ts...>>::type storage_;
+    [[no_unique_address]] std::conditional_t<niche_packed, no_index, index_type> index_{};
+
+    template<class T>
+    static constexpr std::size_t count_ = (std::size_t(std::is_same_v<T, Ts>) + ...);
+
+    template<std::size_t I>
+    constexpr auto& slot_() noexcept { return (compact_variant_slot_of<I>)(storage_); }
+    template<std::size_t I>
+    constexpr const auto& slot_() const noexcept { return (compact_variant_slot_of<I>)(storage_); }
+
+    // Records that the Ith alternative, or no alternative if I is size_,
+    // is active.
+    constexpr void set_index_(std::size_t i) noexcept {
+        if constexpr (niche_packed) {
+            if (i == carrier_)
+                return;
+            const auto k = i < carrier_ ? i : i - 1;
+            const auto b = niche_<carrier_>::value(k);
+            if (i == size_)
+                storage_.raw[head_ - 1] = b;
+            else
+                (variant_dispatch<size_, void>)(i, [&](auto j) {
+                    if constexpr (j != carrier_)
+                        slot_<j>().head[head_ - 1] = b;
+                });
+        } else
+            index_ = static_cast<index_type>(i);
+    }
+
+    constexpr void destroy_() noexcept {
+        if constexpr (!(std::is_trivially_destructible_v<Ts> && ...)) {
+            const auto i = index();
+            if (i != std::variant_npos)
+                (variant_dispatch<size_, void>)(i, [&](auto j) {
+                    std::destroy_at(std::addressof(slot_<j>()));
+                });
+        }
+    }
+
+    template<std::size_t I, class... Args>
+    constexpr void construct_(Args&&... args) {
+        std::construct_at(std::addressof(slot_<I>()), std::in_place,
+            static_cast<Args&&>(args)...);
+        set_index_(I);
+    }
+
+    template<class That>
+    constexpr void construct_from_(That&& that) {
+        const auto i = that.index();
+        if (i == std::variant_npos) {
+            set_index_(size_);
+            return;
+        }
+        (variant_dispatch<size_, void>)(i, [&](auto j) {
+            construct_<j>(static_cast<That&&>(that).template get_<j>());
+        });
+    }
+
+    template<class That>
+    constexpr void assign_from_(That&& that) {
+        const auto i = that.index();
+        if (i == std::variant_npos) {
+            destroy_();
+            set_index_(size_);
+        } else if (i == index())
+            (variant_dispatch<size_, void>)(i, [&](auto j) {
+                get_<j>() = static_cast<That&&>(that).template get_<j>();
+            });
+        else
+            (variant_dispatch<size_, void>)(i, [&](auto j) {
+                emplace<j>(static_cast<That&&>(that).template get_<j>());
+            });
+    }
+
+    template<std::size_t I>
+    constexpr alternative_t<I>& get_() & noexcept { return slot_<I>().value; }
+    template<std::size_t I>
+    constexpr const alternative_t<I>& get_() const& noexcept { return slot_<I>().value; }
+    template<std::size_t I>
+    constexpr alternative_t<I>&& get_() && noexcept { return std::move(slot_<I>().value); }
+    template<std::size_t I>
+    constexpr const alternative_t<I>&& get_() const&& noexcept {
+        return std::move(slot_<I>().value);
+    }
+
+    template<std::size_t I, class V>
+    friend constexpr auto&& compact_variant_get(V&& v);
+public:
+    constexpr compact_variant() noexcept(std::is_nothrow_default_constructible_v<alternative_t<0>>)
+        requires std::is_default_constructible_v<alternative_t<0>>
+    {
+        construct_<0>();
+    }
+
+    template<class T>
+    requires (count_<std::remove_cvref_t<T>> == 1)
+    constexpr compact_variant(T&& v) {
+        construct_<meta_index_of<std::remove_cvref_t<T>, Ts...>::value>(static_cast<T&&>(v));
+    }
+
+    template<class T, class... Args>
+    requires (count_<T> == 1)
+    constexpr explicit compact_variant(std::in_place_type_t<T>, Args&&... args) {
+        construct_<meta_index_of<T, Ts...>::value>(static_cast<Args&&>(args)...);
+    }
+
+    template<std::size_t I, class... Args>
+    requires (I < size_)
+    constexpr explicit compact_variant(std::in_place_index_t<I>, Args&&... args) {
+        construct_<I>(static_cast<Args&&>(args)...);
+    }
+
+    compact_variant(const compact_variant&)
+        requires (std::is_trivially_copy_constructible_v<Ts> && ...) = default;
+    constexpr compact_variant(const compact_variant& that)
+        requires (std::is_copy_constructible_v<Ts> && ...) &&
+                 (!(std::is_trivially_copy_constructible_v<Ts> && ...))
+    {
+        construct_from_(that);
+    }
+
+    compact_variant(compact_variant&&)
+        requires (std::is_trivially_move_constructible_v<Ts> && ...) = default;
+    constexpr compact_variant(compact_variant&& that)
+        noexcept((std::is_nothrow_move_constructible_v<Ts> && ...))
+        requires (std::is_move_constructible_v<Ts> && ...) &&
+                 (!(std::is_trivially_move_constructible_v<Ts> && ...))
+    {
+        construct_from_(std::move(that));
+    }
+
+    compact_variant& operator=(const compact_variant&)
+        requires (std::is_trivially_copyable_v<Ts> && ...) = default;
+    constexpr compact_variant& operator=(const compact_variant& that)
+        requires (std::is_copy_constructible_v<Ts> && ...) &&
+                 (std::is_copy_assignable_v<Ts> && ...) &&
+                 (!(std::is_trivially_copyable_v<Ts> && ...))
+    {
+        if (this != std::addressof(that))
+            assign_from_(that);
+        return *this;
+    }
+
+    compact_variant& operator=(compact_variant&&)
+        requires (std::is_trivially_copyable_v<Ts> && ...) = default;
+    constexpr compact_variant& operator=(compact_variant&& that)
+        noexcept((std::is_nothrow_move_constructible_v<Ts> && ...) &&
+                 (std::is_nothrow_move_assignable_v<Ts> && ...))
+        requires (std::is_move_constructible_v<Ts> && ...) &&
+                 (std::is_move_assignable_v<Ts> && ...) &&
+                 (!(std::is_trivially_copyable_v<Ts> && ...))
+    {
+        if (this != std::addressof(that))
+            assign_from_(std::move(that));
+        return *this;
+    }
+
+    template<class T>
+    requires (count_<std::remove_cvref_t<T>> == 1)
+    constexpr compact_variant& operator=(T&& v) {
+        constexpr auto i = meta_index_of<std::remove_cvref_t<T>, Ts...>::value;
+        if (index() == i)
+            get_<i>() = static_cast<T&&>(v);
+        else
+            emplace<i>(static_cast<T&&>(v));
+        return *this;
+    }
+
+    ~compact_variant() requires (std::is_trivially_destructible_v<Ts> && ...) = default;
+    constexpr ~compact_variant() { destroy_(); }
+
+    // Destroys the active alternative and constructs the Ith one; if that
+    // throws, the compact_variant is left valueless.
+    template<std::size_t I, class... Args>
+    requires (I < size_)
+    constexpr alternative_t<I>& emplace(Args&&... args) {
+        destroy_();
+        set_index_(size_);
+        try {
+            construct_<I>(static_cast<Args&&>(args)...);
+        } catch (...) {
+            // The slot may have overwritten the niche before throwing.
+            set_index_(size_);
+            throw;
+        }
+        return get_<I>();
+    }
+    template<class T, class... Args>
+    requires (count_<T> == 1)
+    constexpr T& emplace(Args&&... args) {
+        return emplace<meta_index_of<T, Ts...>::value>(static_cast<Args&&>(args)...);
+    }
+
+    constexpr std::size_t index() const noexcept {
+        if constexpr (niche_packed) {
+            using niche = niche_<carrier_>;
+            const auto b = reinterpret_cast<const unsigned char*>(
+                std::addressof(storage_))[niche::offset];
+            if (!niche::holds(b))
+                return carrier_;
+            const auto k = niche::index(b);
+            if (k == size_ - 1)
+                return std::variant_npos;
+            return k < carrier_ ? k : k + 1;
+        } else
+            return index_ == size_ ? std::variant_npos : std::size_t(index_);
+    }
+    constexpr bool valueless_by_exception() const noexcept {
+        return index() == std::variant_npos;
+    }
+    template<class T>
+    requires (count_<T> == 1)
+    constexpr bool holds_alternative() const noexcept {
+        return index() == meta_index_of<T, Ts...>::value;
+    }
+};
+
+template<std::size_t I, class V>
+constexpr auto&& compact_variant_get(V&& v) {
+    if (v.index() != I)
+        throw std::bad_variant_access();
+    return static_cast<V&&>(v).template get_<I>();
+}
+
+// Returns the Ith alternative of v, or throws std::bad_variant_access if it
+// is not the active one.
+template<std::size_t I, class... Ts>
+constexpr auto&& variant_get(compact_variant<Ts...>& v) {
+    return (compact_variant_get<I>)(v);
+}
+template<std::size_t I, class... Ts>
+constexpr auto&& variant_get(const compact_variant<Ts...>& v) {
+    return (compact_variant_get<I>)(v);
+}
+template<std::size_t I, class... Ts>
+constexpr auto&& variant_get(compact_variant<Ts...>&& v) {
+    return (compact_variant_get<I>)(std::move(v));
+}
+template<std::size_t I, class... Ts>
+constexpr auto&& variant_get(const compact_variant<Ts...>&& v) {
+    return (compact_variant_get<I>)(std::move(v));
+}
+
+template<class T, class... Ts>
+constexpr auto&& variant_get(compact_variant<Ts...>& v) {
+    return (compact_variant_get<meta_index_of<T, Ts...>::value>)(v);
+}
+template<class T, class... Ts>
+constexpr auto&& variant_get(const compact_variant<Ts...>& v) {
+    return (compact_variant_get<meta_index_of<T, Ts...>::value>)(v);
+}
+template<class T, class... Ts>
+constexpr auto&& variant_get(compact_variant<Ts...>&& v) {
+    return (compact_variant_get<meta_index_of<T, Ts...>::value>)(std::move(v));
+}
+template<class T, class... Ts>
+constexpr auto&& variant_get(const compact_variant<Ts...>&& v) {
+    return (compact_variant_get<meta_index_of<T, Ts...>::value>)(std::move(v));
+}
+
+template<class... Ts>
+struct std::variant_size<compact_variant<Ts...>>
+    : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template<std::size_t I, class... Ts>
+struct std::variant_alternative<I, compact_variant<Ts...>>
+    : std::variant_alternative<I, std::variant<Ts...>> {};
@@ -0,0 +1,202 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class V>
+    struct contiguous_segment;
+
+    template<std::ranges::contiguous_range V, std::ranges::forward_range Pattern>
+    class contiguous_split_view {
+    public:
+        using segment_type = typename contiguous_segment<V>::type;
+
+        contiguous_split_view() = default;
+        constexpr contiguous_split_view(V base, Pattern pattern,
+            std::size_t max_splits = std::size_t(-1));
+        template<std::ranges::input_range R>
+        constexpr contiguous_split_view(R&& r, std::ranges::range_value_t<R> e,
+            std::size_t max_splits = std::size_t(-1));
+
+        constexpr V base() const&;
+        constexpr V base() &&;
+
+        constexpr iterator begin() const;
+        constexpr iterator end() const;
+    };
+*/
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "split_view.hpp"
+#include "two_way_searcher.hpp"
+
+// The type of the segments produced by a contiguous_split_view<V, Pattern>:
+// a std::basic_string_view if V is a string view or a view of a string,
+// and a std::span of the elements of V otherwise.
+template<class V>
+struct contiguous_segment {
+    using type = std::span<std::remove_reference_t<std::ranges::range_reference_t<const V>>>;
+};
+template<class CharT, class Traits>
+struct contiguous_segment<std::basic_string_view<CharT, Traits>> {
+    using type = std::basic_string_view<CharT, Traits>;
+};
+template<class CharT, class Traits, class Alloc>
+struct contiguous_segment<std::ranges::ref_view<std::basic_string<CharT, Traits, Alloc>>> {
+    using type = std::basic_string_view<CharT, Traits>;
+};
+template<class CharT, class Traits, class Alloc>
+struct contiguous_segment<std::ranges::ref_view<const std::basic_string<CharT, Traits, Alloc>>> {
+    using type = std::basic_string_view<CharT, Traits>;
+};
+template<class CharT, class Traits, class Alloc>
+struct contiguous_segment<std::ranges::owning_view<std::basic_string<CharT, Traits, Alloc>>> {
+    using type = std::basic_string_view<CharT, Traits>;
+};
+
+// A contiguous_split_view produces the same segments as the corresponding
+// split_view, but each segment boundary is found once, with the view's
+// two_way_searcher, and each segment is yielded as a sized, contiguous
+// segment_type that points into the base. Downstream code can then use the
+// size and data of whole segments instead of iterating them element by
+// element.
+// With max_splits, at most that many matches are searched for and the rest
+// of the base, unscanned, is the last segment, so a prefix of the segments
+// costs only the elements it spans.
+// The iterator is a forward iterator whose reference type is segment_type.
+// begin() searches for the end of the first segment, so it is not O(1).
+template<std::ranges::contiguous_range V, std::ranges::forward_range Pattern>
+requires std::ranges::view<V> && std::ranges::view<Pattern> &&
+         std::ranges::contiguous_range<const V> && std::ranges::common_range<const V> &&
+         two_way_searchable<Pattern> &&
+         std::indirectly_comparable<std::ranges::iterator_t<const V>,
+             std::ranges::iterator_t<const Pattern>, std::ranges::equal_to>
+class contiguous_split_view
+    : public std::ranges::view_interface<contiguous_split_view<V, Pattern>> {
+public:
+    using segment_type = typename contiguous_segment<V>::type;
+private:
+    [[no_unique_address]] V base_ = V();
+    [[no_unique_address]] Pattern pattern_ = Pattern();
+    [[no_unique_address]] typename pattern_searcher<Pattern>::type searcher_;
+    std::size_t max_splits_ = std::size_t(-1);
+
+    using I = std::ranges::iterator_t<const V>;
+
+    struct iterator {
+    private:
+        friend contiguous_split_view;
+
+        const contiguous_split_view* parent_ = nullptr;
+        I cur_ = I();
+        I seg_end_ = I();
+        I next_ = I();
+        std::size_t splits_ = 0;
+
+        constexpr iterator(const contiguous_split_view& parent, I cur)
+            : parent_(std::addressof(parent)), cur_(cur), seg_end_(cur), next_(cur) {}
+
+        // Finds the end of the segment starting at cur_ and the start of the
+        // following one.
+        constexpr void find_() {
+            const auto end = std::ranges::end(parent_->base_);
+            if (cur_ == end)
+                return;
+            if (splits_ == parent_->max_splits_)
+                seg_end_ = next_ = end;
+            else if (std::ranges::empty(parent_->pattern_))
+                seg_end_ = next_ = std::ranges::next(cur_);
+            else {
+                auto match = parent_->searcher_(cur_, end, parent_->pattern_);
+                seg_end_ = match.begin();
+                next_ = match.end();
+            }
+        }
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = segment_type;
+        using difference_type = std::ranges::range_difference_t<const V>;
+
+        iterator() = default;
+
+        constexpr segment_type operator*() const {
+            return segment_type(std::to_address(cur_),
+                static_cast<std::size_t>(seg_end_ - cur_));
+        }
+
+        constexpr iterator& operator++() {
+            cur_ = next_;
+            ++splits_;
+            find_();
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& x, const iterator& y) {
+            return x.cur_ == y.cur_;
+        }
+        friend constexpr bool operator==(const iterator& x, std::default_sentinel_t) {
+            return x.cur_ == std::ranges::end(x.parent_->base_);
+        }
+    };
+
+public:
+    contiguous_split_view() = default;
+    constexpr contiguous_split_view(V base, Pattern pattern,
+                                    std::size_t max_splits = std::size_t(-1))
+        : base_(std::move(base)), pattern_(std::move(pattern)),
+          searcher_(std::as_const(pattern_)), max_splits_(max_splits) {}
+
+    template<std::ranges::input_range R>
+    requires std::constructible_from<V, std::views::all_t<R>> &&
+             std::constructible_from<Pattern,
+                 std::ranges::single_view<std::ranges::range_value_t<R>>>
+    constexpr contiguous_split_view(R&& r, std::ranges::range_value_t<R> e,
+                                    std::size_t max_splits = std::size_t(-1))
+        : base_(std::views::all(std::forward<R>(r))),
+          pattern_(std::ranges::single_view{std::move(e)}),
+          searcher_(std::as_const(pattern_)), max_splits_(max_splits) {}
+
+    constexpr V base() const& requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr iterator begin() const {
+        iterator it{*this, std::ranges::begin(base_)};
+        it.find_();
+        return it;
+    }
+    constexpr iterator end() const {
+        return iterator{*this, std::ranges::end(base_)};
+    }
+};
+
+template<class R, class P>
+contiguous_split_view(R&&, P&&)
+    -> contiguous_split_view<std::views::all_t<R>, std::views::all_t<P>>;
+
+template<std::ranges::input_range R>
+contiguous_split_view(R&&, std::ranges::range_value_t<R>)
+    -> contiguous_split_view<std::views::all_t<R>,
+        std::ranges::single_view<std::ranges::range_value_t<R>>>;
+
+template<class R, class P>
+contiguous_split_view(R&&, P&&, std::size_t)
+    -> contiguous_split_view<std::views::all_t<R>, std::views::all_t<P>>;
+
+template<std::ranges::input_range R>
+contiguous_split_view(R&&, std::ranges::range_value_t<R>, std::size_t)
+    -> contiguous_split_view<std::views::all_t<R>,
+        std::ranges::single_view<std::ranges::range_value_t<R>>>;
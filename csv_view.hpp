@@ -0,0 +1,280 @@
+#pragma once
+
+/*
+    synopsis
+
+    struct csv_dialect {
+        char delimiter = ',';
+        char quote = '"';
+    };
+
+    struct csv_field {
+        std::string_view value;
+        bool quoted = false;
+        char quote = '"';
+
+        std::string str() const;
+    };
+
+    template<std::ranges::contiguous_range V>
+    class csv_view {
+    public:
+        csv_view() = default;
+        constexpr explicit csv_view(V base, csv_dialect dialect = {});
+
+        constexpr V base() const&;
+        constexpr V base() &&;
+
+        iterator begin();
+        std::default_sentinel_t end() const noexcept;
+    };
+*/
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd_find.hpp"
+
+struct csv_dialect {
+    char delimiter = ',';
+    char quote = '"';
+};
+
+// A field of a CSV record. value is the text of the field, without the
+// enclosing quotes if the field is quoted; it points into the parsed buffer.
+// In a quoted field, a quote character is escaped by doubling it and value
+// still contains both; str() returns the field with the escapes collapsed.
+struct csv_field {
+    std::string_view value;
+    bool quoted = false;
+    char quote = '"';
+
+    std::string str() const {
+        std::string s;
+        if (!quoted) {
+            s.assign(value);
+            return s;
+        }
+        s.reserve(value.size());
+        for (std::size_t i = 0; i != value.size(); ++i) {
+            s.push_back(value[i]);
+            if (value[i] == quote && i + 1 != value.size() && value[i + 1] == quote)
+                ++i;
+        }
+        return s;
+    }
+};
+
+// Bitmasks of the quote, delimiter and newline characters of a 64-byte
+// block; bit i corresponds to byte i.
+struct csv_block_masks {
+    std::uint64_t quote;
+    std::uint64_t delimiter;
+    std::uint64_t newline;
+};
+
+inline csv_block_masks csv_classify(const char* p, char quote, char delimiter) noexcept {
+#ifdef SIMD_FIND_X86
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i d = _mm_set1_epi8(delimiter);
+    const __m128i nl = _mm_set1_epi8('\n');
+    csv_block_masks m{ 0, 0, 0 };
+    for (int i = 0; i != 4; ++i) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        const auto shift = 16 * i;
+        m.quote |= std::uint64_t(static_cast<std::uint16_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(x, q)))) << shift;
+        m.delimiter |= std::uint64_t(static_cast<std::uint16_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(x, d)))) << shift;
+        m.newline |= std::uint64_t(static_cast<std::uint16_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(x, nl)))) << shift;
+    }
+    return m;
+#else
+    csv_block_masks m{ 0, 0, 0 };
+    for (int i = 0; i != 64; ++i) {
+        m.quote |= std::uint64_t(p[i] == quote) << i;
+        m.delimiter |= std::uint64_t(p[i] == delimiter) << i;
+        m.newline |= std::uint64_t(p[i] == '\n') << i;
+    }
+    return m;
+#endif
+}
+
+// Bit i of the result is the XOR of bits 0 to i of x.
+constexpr std::uint64_t prefix_xor(std::uint64_t x) noexcept {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// A csv_view parses a contiguous range of chars as RFC 4180 CSV (or TSV,
+// with csv_dialect{'\t'}) and produces one std::span<const csv_field> per
+// record. Records are separated by newlines (a preceding '\r' is dropped);
+// delimiters and newlines inside quoted fields are part of the field. As
+// with split_view, a trailing newline does not start a final empty record.
+// The range is parsed in a single pass, 64 bytes at a time: the quote,
+// delimiter and newline bytes of a block are turned into bitmasks, the
+// prefix XOR of the quote mask gives the bytes that are inside quotes, and
+// the remaining delimiters and newlines are the field and record boundaries.
+// The boundaries of a block that are not consumed by one record are kept
+// for the next, so each block is classified once.
+// No field is copied; the fields of the current record are kept in a buffer
+// owned by the view, which is reused for every record, so the spans are
+// invalidated by incrementing the iterator. The view is therefore an input
+// range and begin() may only be called once per pass.
+template<std::ranges::contiguous_range V>
+requires std::ranges::view<V> && std::same_as<std::ranges::range_value_t<V>, char>
+class csv_view : public std::ranges::view_interface<csv_view<V>> {
+    [[no_unique_address]] V base_ = V();
+    csv_dialect dialect_;
+    const char* cur_ = nullptr;
+    const char* next_ = nullptr;
+    const char* block_ = nullptr;
+    std::uint64_t boundaries_ = 0;
+    std::uint64_t newlines_ = 0;
+    std::uint64_t in_quotes_ = 0;
+    std::vector<csv_field> fields_;
+
+    constexpr const char* data_end_() const {
+        return std::to_address(std::ranges::begin(base_)) + std::ranges::distance(base_);
+    }
+
+    // Computes the field and record boundaries of the block starting at
+    // block_. in_quotes_ is all ones if the previous block ended inside a
+    // quoted field.
+    void classify_() {
+        const auto n = static_cast<std::size_t>(data_end_() - block_);
+        const char* block = block_;
+        std::uint64_t valid = ~std::uint64_t(0);
+        char tail[64];
+        if (n < 64) {
+            // The padding must not be classified; any byte that is none of
+            // the three special characters will do.
+            char pad = '\0';
+            while (pad == dialect_.quote || pad == dialect_.delimiter || pad == '\n')
+                ++pad;
+            std::memset(tail, pad, sizeof tail);
+            std::memcpy(tail, block_, n);
+            block = tail;
+            valid = (std::uint64_t(1) << n) - 1;
+        }
+        const auto m = (csv_classify)(block, dialect_.quote, dialect_.delimiter);
+        const std::uint64_t in_quotes = (prefix_xor)(m.quote) ^ in_quotes_;
+        in_quotes_ = std::uint64_t(0) - (in_quotes >> 63);
+        boundaries_ = (m.delimiter | m.newline) & ~in_quotes & valid;
+        newlines_ = m.newline;
+    }
+
+    // Strips the enclosing quotes without branching on them; whether a
+    // field is quoted is rarely predictable.
+    void push_field_(const char* first, const char* last) {
+        const auto n = static_cast<std::size_t>(last - first);
+        const bool quoted = n != 0 && first[0] == dialect_.quote;
+        const bool closed = quoted && n > 1 && last[-1] == dialect_.quote;
+        fields_.push_back({ std::string_view(first + quoted, n - quoted - closed),
+            quoted, dialect_.quote });
+    }
+
+    // Parses the record starting at cur_ into fields_ and sets next_ to the
+    // start of the following record.
+    void parse_() {
+        fields_.clear();
+        const char* const end = data_end_();
+        const char* field = cur_;
+        for (;;) {
+            while (boundaries_ == 0) {
+                if (end - block_ <= 64) {
+                    const char* last = end;
+                    if (last != field && last[-1] == '\r')
+                        --last;
+                    push_field_(field, last);
+                    next_ = end;
+                    return;
+                }
+                block_ += 64;
+                classify_();
+            }
+            const auto i = std::countr_zero(boundaries_);
+            boundaries_ &= boundaries_ - 1;
+            const char* pos = block_ + i;
+            if (newlines_ >> i & 1) {
+                const char* last = pos;
+                if (last != field && last[-1] == '\r')
+                    --last;
+                push_field_(field, last);
+                next_ = pos + 1;
+                return;
+            }
+            push_field_(field, pos);
+            field = pos + 1;
+        }
+    }
+
+    struct iterator {
+    private:
+        csv_view* parent_ = nullptr;
+
+        bool at_end_() const { return parent_->cur_ == parent_->data_end_(); }
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = std::span<const csv_field>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(csv_view& parent) noexcept : parent_(std::addressof(parent)) {}
+
+        std::span<const csv_field> operator*() const noexcept { return parent_->fields_; }
+
+        iterator& operator++() {
+            parent_->cur_ = parent_->next_;
+            if (parent_->cur_ != parent_->data_end_())
+                parent_->parse_();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& x, std::default_sentinel_t) {
+            return x.at_end_();
+        }
+    };
+public:
+    csv_view() = default;
+    constexpr explicit csv_view(V base, csv_dialect dialect = {})
+        : base_(std::move(base)), dialect_(dialect) {}
+
+    constexpr V base() const& requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    iterator begin() {
+        cur_ = std::to_address(std::ranges::begin(base_));
+        block_ = cur_;
+        in_quotes_ = 0;
+        if (cur_ != data_end_()) {
+            classify_();
+            parse_();
+        }
+        return iterator(*this);
+    }
+    std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+};
+
+template<class R>
+csv_view(R&&) -> csv_view<std::views::all_t<R>>;
+
+template<class R>
+csv_view(R&&, csv_dialect) -> csv_view<std::views::all_t<R>>;
@@ -0,0 +1,169 @@
+#pragma once
+
+/*
+    synopsis
+
+    class delimiter_set {
+    public:
+        constexpr delimiter_set() noexcept;
+        constexpr explicit delimiter_set(std::string_view chars) noexcept;
+
+        template<simd_findable T> requires (sizeof(T) == 1)
+        constexpr bool contains(T c) const noexcept;
+
+        template<simd_findable T> requires (sizeof(T) == 1)
+        const T* find(const T* first, const T* last) const noexcept;
+    };
+*/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "simd_find.hpp"
+
+// A delimiter_set is a set of byte values, used to split on any one of
+// several delimiters. Membership is tested with a 256-bit bitmap.
+// find() classifies 16 or 32 bytes at a time with two 16-entry nibble
+// tables (pshufb): for a byte b, lo[b & 15] & hi[b >> 4] is non-zero iff b
+// is in the set. The tables give each distinct set of low nibbles sharing a
+// high nibble its own bit, so they are exact for any set in which at most
+// 8 such distinct sets occur (which covers all sets of up to 8 bytes, and
+// e.g. all ASCII whitespace and punctuation); for other sets find() falls
+// back to the bitmap.
+class delimiter_set {
+    std::array<std::uint64_t, 4> bits_{};
+    std::array<std::uint8_t, 16> lo_{};
+    std::array<std::uint8_t, 16> hi_{};
+    bool nibble_exact_ = true;
+
+    constexpr bool test(unsigned char c) const noexcept {
+        return (bits_[c >> 6] >> (c & 63)) & 1;
+    }
+
+    template<class T>
+    constexpr const T* scalar_find(const T* first, const T* last) const noexcept {
+        for (; first != last; ++first)
+            if (test(static_cast<unsigned char>(*first)))
+                return first;
+        return last;
+    }
+
+#ifdef SIMD_FIND_X86
+#if defined(__GNUC__)
+    template<class T>
+    __attribute__((target("ssse3")))
+    const T* ssse3_find(const T* first, const T* last) const noexcept {
+        constexpr std::ptrdiff_t n = 16;
+        if (last - first < n)
+            return scalar_find(first, last);
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo_.data()));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi_.data()));
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const auto match = [&](const T* p) __attribute__((target("ssse3"))) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(x, nibble));
+            const __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+            const __m128i none = _mm_cmpeq_epi8(_mm_and_si128(l, h), _mm_setzero_si128());
+            return static_cast<std::uint32_t>(~_mm_movemask_epi8(none) & 0xffff);
+        };
+        for (; last - first >= n; first += n)
+            if (const auto m = match(first))
+                return first + (simd_find_ctz)(m);
+        if (first == last)
+            return last;
+        first = last - n;
+        if (const auto m = match(first))
+            return first + (simd_find_ctz)(m);
+        return last;
+    }
+
+    template<class T>
+    SIMD_FIND_TARGET_AVX2
+    const T* avx2_find(const T* first, const T* last) const noexcept {
+        constexpr std::ptrdiff_t n = 32;
+        if (last - first < n)
+            return ssse3_find(first, last);
+        const __m256i lo = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo_.data())));
+        const __m256i hi = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi_.data())));
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        const auto match = [&](const T* p) SIMD_FIND_TARGET_AVX2 {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(x, nibble));
+            const __m256i h = _mm256_shuffle_epi8(hi,
+                _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+            const __m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(l, h),
+                _mm256_setzero_si256());
+            return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(none));
+        };
+        for (; last - first >= n; first += n)
+            if (const auto m = match(first))
+                return first + (simd_find_ctz)(m);
+        if (first == last)
+            return last;
+        first = last - n;
+        if (const auto m = match(first))
+            return first + (simd_find_ctz)(m);
+        return last;
+    }
+#endif
+#endif
+public:
+    constexpr delimiter_set() noexcept = default;
+
+    constexpr explicit delimiter_set(std::string_view chars) noexcept {
+        for (const char ch : chars) {
+            const auto c = static_cast<unsigned char>(ch);
+            bits_[c >> 6] |= std::uint64_t(1) << (c & 63);
+        }
+        // Give each distinct set of low nibbles (one per high nibble) a bit.
+        std::array<std::uint16_t, 8> classes{};
+        std::size_t count = 0;
+        for (unsigned h = 0; h != 16; ++h) {
+            std::uint16_t lows = 0;
+            for (unsigned l = 0; l != 16; ++l)
+                if (test(static_cast<unsigned char>(h << 4 | l)))
+                    lows |= static_cast<std::uint16_t>(1u << l);
+            if (lows == 0)
+                continue;
+            std::size_t k = 0;
+            while (k != count && classes[k] != lows)
+                ++k;
+            if (k == count) {
+                if (count == classes.size()) {
+                    nibble_exact_ = false;
+                    return;
+                }
+                classes[count++] = lows;
+            }
+            hi_[h] |= static_cast<std::uint8_t>(1u << k);
+            for (unsigned l = 0; l != 16; ++l)
+                if (lows >> l & 1)
+                    lo_[l] |= static_cast<std::uint8_t>(1u << k);
+        }
+    }
+
+    template<simd_findable T> requires (sizeof(T) == 1)
+    constexpr bool contains(T c) const noexcept {
+        return test(static_cast<unsigned char>(c));
+    }
+
+    // Returns a pointer to the first element of [first, last) that is in
+    // the set, or last if there is none. Like simd_find, it chooses between
+    // AVX2, SSSE3 and a plain loop at run time and never reads outside of
+    // [first, last).
+    template<simd_findable T> requires (sizeof(T) == 1)
+    const T* find(const T* first, const T* last) const noexcept {
+#if defined(SIMD_FIND_X86) && defined(__GNUC__)
+        if (nibble_exact_) {
+            if ((simd_find_has_avx2)())
+                return avx2_find(first, last);
+            if ((simd_find_has_ssse3)())
+                return ssse3_find(first, last);
+        }
+#endif
+        return scalar_find(first, last);
+    }
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class T, std::size_t N>
+    struct fixed_string {
+        std::array<T, N> elems;
+
+        constexpr fixed_string(const T (&s)[N + 1]) noexcept;
+        constexpr fixed_string(const std::array<T, N>& a) noexcept;
+
+        static constexpr std::size_t size() noexcept;
+    };
+
+    template<fixed_string S>
+    struct fixed_pattern {
+        static constexpr std::size_t size() noexcept;
+        static constexpr const value_type* begin() noexcept;
+        static constexpr const value_type* end() noexcept;
+    };
+
+    template<fixed_string S>
+    class fixed_searcher {
+    public:
+        constexpr fixed_searcher() noexcept = default;
+        constexpr explicit fixed_searcher(const fixed_pattern<S>&) noexcept;
+
+        template<std::random_access_iterator I, std::sized_sentinel_for<I> Sent, class P>
+        constexpr std::ranges::subrange<I> operator()(I first, Sent last, const P&) const;
+    };
+
+    template<fixed_string S>
+    struct pattern_searcher<fixed_pattern<S>>;
+*/
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "simd_find.hpp"
+#include "two_way_searcher.hpp"
+
+// A sequence of N elements usable as a template argument. Built from a
+// string literal, whose terminating null is dropped, or from a std::array.
+template<class T, std::size_t N>
+struct fixed_string {
+    using value_type = T;
+
+    std::array<T, N> elems{};
+
+    constexpr fixed_string(const T (&s)[N + 1]) noexcept {
+        std::copy_n(s, N, elems.begin());
+    }
+    constexpr fixed_string(const std::array<T, N>& a) noexcept : elems(a) {}
+
+    static constexpr std::size_t size() noexcept { return N; }
+};
+
+template<class T, std::size_t N>
+fixed_string(const T (&)[N]) -> fixed_string<T, N - 1>;
+
+template<class T, std::size_t N>
+fixed_string(const std::array<T, N>&) -> fixed_string<T, N>;
+
+// A fixed_pattern is an empty view of the elements of S, e.g.
+// split_view(text, fixed_pattern<"\r\n">{}). Its size is a constant
+// expression, and the split views search for it with a fixed_searcher, for
+// which everything that depends on the pattern is computed at compile time.
+template<fixed_string S>
+struct fixed_pattern : std::ranges::view_interface<fixed_pattern<S>> {
+    using value_type = typename decltype(S)::value_type;
+
+    static constexpr std::size_t size() noexcept { return S.size(); }
+    static constexpr const value_type* begin() noexcept { return S.elems.data(); }
+    static constexpr const value_type* end() noexcept { return S.elems.data() + S.size(); }
+};
+
+// A fixed_searcher finds the first occurrence of S, a pattern known at
+// compile time, and holds no state.
+// Over contiguous one-byte text it uses the SIMD first/last-element filter:
+// a block of candidate positions i is kept where text[i] == S[0] and
+// text[i + m - 1] == S[m - 1], and only those are compared with the
+// pattern, by a fully unrolled comparison. The rest of the text, and
+// text of other types, is searched with Horspool's algorithm, whose shift
+// table (for one-byte elements) is a constant. A single-element pattern is
+// searched for with simd_find.
+template<fixed_string S>
+class fixed_searcher {
+    using T = typename decltype(S)::value_type;
+    static constexpr std::ptrdiff_t m = static_cast<std::ptrdiff_t>(S.size());
+    static constexpr bool one_byte = simd_findable<T> && sizeof(T) == 1;
+
+    static constexpr std::array<unsigned char, 256> shift_ = [] {
+        std::array<unsigned char, 256> shift{};
+        if constexpr (one_byte) {
+            const auto cap = static_cast<unsigned char>(std::min<std::ptrdiff_t>(m, 255));
+            shift.fill(cap);
+            for (std::ptrdiff_t i = 0; i + 1 < m; ++i)
+                shift[static_cast<unsigned char>(S.elems[static_cast<std::size_t>(i)])] =
+                    static_cast<unsigned char>(std::min<std::ptrdiff_t>(m - 1 - i, 255));
+        }
+        return shift;
+    }();
+
+    template<class I, std::size_t... Is>
+    static constexpr bool equal_(I it, std::index_sequence<Is...>) {
+        return ((it[static_cast<std::iter_difference_t<I>>(Is)] == S.elems[Is]) && ...);
+    }
+
+    // Whether the pattern occurs at it, comparing the elements in the
+    // order 0, 1, ..., m - 1.
+    template<class I>
+    static constexpr bool matches_(I it) {
+        return (equal_)(it, std::make_index_sequence<S.size()>());
+    }
+
+    template<class I>
+    static constexpr std::ptrdiff_t horspool_(I first, std::ptrdiff_t j, std::ptrdiff_t n) {
+        while (j <= n - m) {
+            const auto& last = first[j + m - 1];
+            if (last == S.elems[S.size() - 1] && (matches_)(first + j))
+                return j;
+            if constexpr (one_byte)
+                j += shift_[static_cast<unsigned char>(last)];
+            else
+                ++j;
+        }
+        return n;
+    }
+
+#ifdef SIMD_FIND_X86
+    static std::ptrdiff_t sse2_(const T* p, std::ptrdiff_t n) noexcept {
+        constexpr std::ptrdiff_t w = 16;
+        const __m128i first = _mm_set1_epi8(static_cast<char>(S.elems[0]));
+        const __m128i last = _mm_set1_epi8(static_cast<char>(S.elems[S.size() - 1]));
+        std::ptrdiff_t j = 0;
+        for (; j + m - 1 + w <= n; j += w) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j + m - 1));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+            for (; mask; mask &= mask - 1) {
+                const auto i = j + (simd_find_ctz)(mask);
+                if ((matches_)(p + i))
+                    return i;
+            }
+        }
+        return (horspool_)(p, j, n);
+    }
+
+#if defined(__GNUC__)
+    SIMD_FIND_TARGET_AVX2
+    static std::ptrdiff_t avx2_(const T* p, std::ptrdiff_t n) noexcept {
+        constexpr std::ptrdiff_t w = 32;
+        const __m256i first = _mm256_set1_epi8(static_cast<char>(S.elems[0]));
+        const __m256i last = _mm256_set1_epi8(static_cast<char>(S.elems[S.size() - 1]));
+        std::ptrdiff_t j = 0;
+        for (; j + m - 1 + w <= n; j += w) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + j));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + j + m - 1));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+            for (; mask; mask &= mask - 1) {
+                const auto i = j + (simd_find_ctz)(mask);
+                if ((matches_)(p + i))
+                    return i;
+            }
+        }
+        return (sse2_)(p + j, n - j) + j;
+    }
+#endif
+#endif
+public:
+    constexpr fixed_searcher() noexcept = default;
+    constexpr explicit fixed_searcher(const fixed_pattern<S>&) noexcept {}
+
+    // Returns the first occurrence of S in [first, last), or an empty range
+    // at last if there is none. The pattern argument is ignored.
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> Sent, class P>
+    constexpr std::ranges::subrange<I> operator()(I first, Sent last, const P&) const {
+        const auto n = static_cast<std::ptrdiff_t>(last - first);
+        if constexpr (m == 0) {
+            return { first, first };
+        } else {
+            std::ptrdiff_t j = n;
+            if constexpr (std::contiguous_iterator<I> &&
+                std::same_as<std::iter_value_t<I>, T> && simd_findable<T>)
+            {
+                if (!std::is_constant_evaluated()) {
+                    const auto p = std::to_address(first);
+                    if constexpr (m == 1)
+                        j = (simd_find)(p, p + n, S.elems[0]) - p;
+#ifdef SIMD_FIND_X86
+                    else if constexpr (one_byte) {
+#if defined(__GNUC__)
+                        if ((simd_find_has_avx2)())
+                            j = (avx2_)(p, n);
+                        else
+#endif
+                            j = (sse2_)(p, n);
+                    }
+#endif
+                    else
+                        j = (horspool_)(p, 0, n);
+                    return { first + j, first + (j == n ? j : j + m) };
+                }
+            }
+            j = (horspool_)(first, 0, n);
+            return { first + j, first + (j == n ? j : j + m) };
+        }
+    }
+};
+
+template<fixed_string S>
+struct pattern_searcher<fixed_pattern<S>> {
+    using type = fixed_searcher<S>;
+};
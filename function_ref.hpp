@@ -0,0 +1,108 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class Sig>
+    class function_ref;
+
+    template<class R, class... Args, bool NoExcept>
+    class function_ref<R(Args...) noexcept(NoExcept)> {
+    public:
+        template<class F>
+        constexpr function_ref(F&& f) noexcept;
+
+        constexpr function_ref(const function_ref&) noexcept = default;
+        constexpr function_ref& operator=(const function_ref&) noexcept = default;
+
+        R operator()(Args... args) const noexcept(NoExcept);
+    };
+*/
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "invoke.hpp"
+
+template<class Sig>
+class function_ref;
+
+// A function_ref<R(Args...)> refers to a callable object, or to a
+// function, which it calls through invoke<R> with Args..., like a
+// std::function that does not own its target: it is trivially copyable,
+// and never allocates. It is meant for parameters that take a callback for
+// the duration of the call; it must not outlive the object it refers to,
+// which is a concern when it is bound to a temporary. Functions, function
+// pointers and pointers to members are copied into the function_ref
+// instead, so it is as large as a pointer to member function and a
+// pointer.
+// The target object is called as an lvalue, with the constness it was
+// passed with. With a noexcept signature, the target must be nothrow
+// invocable.
+template<class R, class... Args, bool NoExcept>
+class function_ref<R(Args...) noexcept(NoExcept)> {
+    // A pointer to member of an incomplete class has the most general
+    // representation, so any pointer to member fits in mp.
+    struct incomplete;
+    union target {
+        void* obj;
+        const void* cobj;
+        void (*fn)();
+        alignas(void (incomplete::*)()) unsigned char mp[sizeof(void (incomplete::*)())];
+    };
+
+    target target_;
+    R (*call_)(target, Args&&...) noexcept(NoExcept);
+
+    template<class F>
+    static constexpr bool invocable_ = NoExcept ?
+        std::is_nothrow_invocable_r_v<R, F, Args...> :
+        std::is_invocable_r_v<R, F, Args...>;
+public:
+    template<class F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, function_ref>) &&
+             invocable_<std::remove_reference_t<F>&>
+    constexpr function_ref(F&& f) noexcept {
+        using T = std::remove_reference_t<F>;
+        // A function, or a pointer to one, is referred to by its address,
+        // which is copied rather than pointed to, as is a pointer to member.
+        using P = std::conditional_t<std::is_function_v<T>, T*, std::remove_cv_t<T>>;
+        if constexpr (std::is_pointer_v<P> && std::is_function_v<std::remove_pointer_t<P>>) {
+            target_.fn = reinterpret_cast<void (*)()>(static_cast<P>(f));
+            call_ = [](target t, Args&&... args) noexcept(NoExcept) -> R {
+                return (invoke<R>)(reinterpret_cast<P>(t.fn), static_cast<Args&&>(args)...);
+            };
+        } else if constexpr (std::is_member_pointer_v<P>) {
+            static_assert(sizeof(P) <= sizeof(target::mp) && alignof(target) % alignof(P) == 0,
+                "The pointer to member does not fit in the function_ref.");
+            const P value = f;
+            std::memcpy(target_.mp, std::addressof(value), sizeof(P));
+            call_ = [](target t, Args&&... args) noexcept(NoExcept) -> R {
+                P pm;
+                std::memcpy(std::addressof(pm), t.mp, sizeof(P));
+                return (invoke<R>)(pm, static_cast<Args&&>(args)...);
+            };
+        } else if constexpr (std::is_const_v<T>) {
+            target_.cobj = std::addressof(f);
+            call_ = [](target t, Args&&... args) noexcept(NoExcept) -> R {
+                return (invoke<R>)(*static_cast<T*>(t.cobj), static_cast<Args&&>(args)...);
+            };
+        } else {
+            target_.obj = std::addressof(f);
+            call_ = [](target t, Args&&... args) noexcept(NoExcept) -> R {
+                return (invoke<R>)(*static_cast<T*>(t.obj), static_cast<Args&&>(args)...);
+            };
+        }
+    }
+
+    constexpr function_ref(const function_ref&) noexcept = default;
+    constexpr function_ref& operator=(const function_ref&) noexcept = default;
+
+    R operator()(Args... args) const noexcept(NoExcept) {
+        return call_(target_, static_cast<Args&&>(args)...);
+    }
+};
+
+template<class R, class... Args>
+function_ref(R (*)(Args...)) -> function_ref<R(Args...)>;
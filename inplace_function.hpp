@@ -0,0 +1,218 @@
+#pragma once
+
+/*
+    synopsis
+
+    inline constexpr std::size_t inplace_function_capacity = 4 * sizeof(void*);
+
+    template<class Sig, std::size_t Capacity = inplace_function_capacity,
+             std::size_t Alignment = alignof(void*)>
+    class inplace_function;
+
+    template<class R, class... Args, bool NoExcept, std::size_t Capacity, std::size_t Alignment>
+    class inplace_function<R(Args...) noexcept(NoExcept), Capacity, Alignment> {
+    public:
+        inplace_function() noexcept;
+        inplace_function(std::nullptr_t) noexcept;
+        template<class F>
+        inplace_function(F&& f);
+        template<class F, class... CArgs>
+        explicit inplace_function(std::in_place_type_t<F>, CArgs&&... args);
+
+        inplace_function(inplace_function&& that) noexcept;
+        inplace_function& operator=(inplace_function&& that) noexcept;
+        inplace_function& operator=(std::nullptr_t) noexcept;
+        ~inplace_function();
+
+        explicit operator bool() const noexcept;
+        R operator()(Args... args) const noexcept(NoExcept);
+    };
+*/
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "invoke.hpp"
+
+// The default capacity of an inplace_function: room for a lambda that
+// captures four pointers, or for a Bind of a member function pointer and
+// two pointers. The default alignment is that of a pointer.
+inline constexpr std::size_t inplace_function_capacity = 4 * sizeof(void*);
+
+template<class Sig, std::size_t Capacity = inplace_function_capacity,
+         std::size_t Alignment = alignof(void*)>
+class inplace_function;
+
+template<class>
+inline constexpr bool is_inplace_function_v = false;
+template<class Sig, std::size_t Capacity, std::size_t Alignment>
+inline constexpr bool is_inplace_function_v<inplace_function<Sig, Capacity, Alignment>> = true;
+
+// How the call of an inplace_function passes an argument of type T to its
+// target: by value, in registers, if T is small and trivially copyable,
+// else by reference.
+template<class T>
+using inplace_function_param_t = std::conditional_t<
+    std::is_trivially_copyable_v<T> && sizeof(T) <= 2 * sizeof(void*), T, T&&>;
+
+// The operations on the target of an inplace_function, one table per
+// target type; call is also held by the inplace_function itself, to save
+// a load per call. Moving a target leaves the source destroyed. A
+// trivially copyable target has no relocate nor destroy: it is moved by
+// copying the buffer, and needs no destruction.
+template<class R, bool NoExcept, class... Args>
+struct inplace_function_vtable {
+    R (*call)(void*, inplace_function_param_t<Args>...) noexcept(NoExcept);
+    void (*relocate)(void* dst, void* src) noexcept;
+    void (*destroy)(void*) noexcept;
+
+    // An empty noexcept inplace_function terminates when called.
+    static R empty_call(void*, inplace_function_param_t<Args>...) noexcept(NoExcept) {
+        if constexpr (NoExcept)
+            std::terminate();
+        else
+            throw std::bad_function_call();
+    }
+
+    template<class F>
+    static R target_call(void* p, inplace_function_param_t<Args>... args) noexcept(NoExcept) {
+        return (invoke<R>)(*static_cast<F*>(p), static_cast<Args&&>(args)...);
+    }
+    template<class F>
+    static void target_relocate(void* dst, void* src) noexcept {
+        ::new (dst) F(std::move(*static_cast<F*>(src)));
+        static_cast<F*>(src)->~F();
+    }
+    template<class F>
+    static void target_destroy(void* p) noexcept {
+        static_cast<F*>(p)->~F();
+    }
+};
+
+template<class R, bool NoExcept, class... Args>
+inline constexpr inplace_function_vtable<R, NoExcept, Args...> inplace_function_empty = {
+    &inplace_function_vtable<R, NoExcept, Args...>::empty_call, nullptr, nullptr
+};
+
+template<class R, bool NoExcept, class F, class... Args>
+inline constexpr inplace_function_vtable<R, NoExcept, Args...> inplace_function_table = {
+    &inplace_function_vtable<R, NoExcept, Args...>::template target_call<F>,
+    std::is_trivially_copyable_v<F> ? nullptr :
+        &inplace_function_vtable<R, NoExcept, Args...>::template target_relocate<F>,
+    std::is_trivially_copyable_v<F> ? nullptr :
+        &inplace_function_vtable<R, NoExcept, Args...>::template target_destroy<F>
+};
+
+// An inplace_function<R(Args...), Capacity> holds a callable object, which
+// it calls through invoke<R> with Args..., like a std::function, but in a
+// buffer of Capacity bytes inside the inplace_function: it never
+// allocates, and a target that does not fit, or is more aligned than
+// Alignment, is a compile-time error rather than a heap allocation. It is
+// move-only, so targets need only be nothrow move constructible, and a
+// call goes through one indirect call, with no check for emptiness; an
+// empty inplace_function throws std::bad_function_call when called.
+// As with std::function, the target is called as a non-const lvalue even
+// though operator() is const.
+template<class R, class... Args, bool NoExcept, std::size_t Capacity, std::size_t Alignment>
+class inplace_function<R(Args...) noexcept(NoExcept), Capacity, Alignment> {
+    using vtable = inplace_function_vtable<R, NoExcept, Args...>;
+
+    const vtable* vtable_ = &inplace_function_empty<R, NoExcept, Args...>;
+    R (*call_)(void*, inplace_function_param_t<Args>...) noexcept(NoExcept) = vtable_->call;
+    alignas(Alignment) mutable unsigned char buf_[Capacity];
+
+    void relocate_(inplace_function& that) noexcept {
+        if (vtable_->relocate)
+            vtable_->relocate(buf_, that.buf_);
+        else
+            std::memcpy(buf_, that.buf_, Capacity);
+    }
+    void destroy_() noexcept {
+        if (vtable_->destroy)
+            vtable_->destroy(buf_);
+    }
+
+    template<class F>
+    static constexpr bool invocable_ = NoExcept ?
+        std::is_nothrow_invocable_r_v<R, F&, Args...> :
+        std::is_invocable_r_v<R, F&, Args...>;
+
+    template<class F, class... CArgs>
+    void construct_(CArgs&&... args) {
+        static_assert(sizeof(F) <= Capacity,
+            "The target object does not fit in the inplace_function.");
+        static_assert(Alignment % alignof(F) == 0,
+            "The target object is more aligned than the inplace_function.");
+        static_assert(std::is_nothrow_move_constructible_v<F>,
+            "The target object must be nothrow move constructible.");
+        ::new (static_cast<void*>(buf_)) F(static_cast<CArgs&&>(args)...);
+        vtable_ = &inplace_function_table<R, NoExcept, F, Args...>;
+        call_ = vtable_->call;
+    }
+public:
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    // As with std::function, a null function pointer or pointer to member
+    // makes an empty inplace_function.
+    template<class F>
+    requires (!is_inplace_function_v<std::remove_cvref_t<F>>) &&
+             (!std::is_same_v<std::remove_cvref_t<F>, std::nullptr_t>) &&
+             invocable_<std::decay_t<F>>
+    inplace_function(F&& f) {
+        using T = std::remove_cvref_t<F>;
+        if constexpr (std::is_pointer_v<T> || std::is_member_pointer_v<T>) {
+            if (f == nullptr)
+                return;
+        }
+        construct_<std::decay_t<F>>(static_cast<F&&>(f));
+    }
+
+    template<class F, class... CArgs>
+    requires invocable_<F>
+    explicit inplace_function(std::in_place_type_t<F>, CArgs&&... args) {
+        construct_<F>(static_cast<CArgs&&>(args)...);
+    }
+
+    inplace_function(inplace_function&& that) noexcept
+        : vtable_(that.vtable_), call_(that.call_)
+    {
+        relocate_(that);
+        that.vtable_ = &inplace_function_empty<R, NoExcept, Args...>;
+        that.call_ = that.vtable_->call;
+    }
+
+    inplace_function& operator=(inplace_function&& that) noexcept {
+        if (this != std::addressof(that)) {
+            destroy_();
+            vtable_ = that.vtable_;
+            call_ = that.call_;
+            relocate_(that);
+            that.vtable_ = &inplace_function_empty<R, NoExcept, Args...>;
+            that.call_ = that.vtable_->call;
+        }
+        return *this;
+    }
+
+    inplace_function& operator=(std::nullptr_t) noexcept {
+        destroy_();
+        vtable_ = &inplace_function_empty<R, NoExcept, Args...>;
+        call_ = vtable_->call;
+        return *this;
+    }
+
+    ~inplace_function() { destroy_(); }
+
+    explicit operator bool() const noexcept {
+        return vtable_ != &inplace_function_empty<R, NoExcept, Args...>;
+    }
+
+    R operator()(Args... args) const noexcept(NoExcept) {
+        return call_(buf_, static_cast<Args&&>(args)...);
+    }
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+/*
+    synopsis
+
+    struct mapped_file_options {
+        bool sequential = true;
+        bool willneed = false;
+        bool huge_pages = false;
+    };
+
+    class mapped_file_view {
+    public:
+        mapped_file_view() = default;
+        explicit mapped_file_view(const std::filesystem::path&, mapped_file_options = {});
+        mapped_file_view(mapped_file_view&&) noexcept;
+        mapped_file_view& operator=(mapped_file_view&&) noexcept;
+        ~mapped_file_view();
+
+        const char* begin() const noexcept;
+        const char* end() const noexcept;
+        const char* data() const noexcept;
+        std::size_t size() const noexcept;
+
+        void evict(const char* first, const char* last) const noexcept;
+    };
+*/
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ranges>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "contiguous_split_view.hpp"
+
+// Hints applied to the mapping of a mapped_file_view.
+// sequential: madvise(MADV_SEQUENTIAL); the kernel reads ahead aggressively
+//     and may drop pages soon after they have been accessed.
+// willneed: madvise(MADV_WILLNEED); start reading the whole file now.
+// huge_pages: align the mapping to a 2 MiB boundary and, where supported,
+//     madvise(MADV_HUGEPAGE), so that the kernel can back it with huge pages
+//     (e.g. for files on tmpfs/hugetlbfs or with read-only file THP).
+struct mapped_file_options {
+    bool sequential = true;
+    bool willneed = false;
+    bool huge_pages = false;
+};
+
+// A mapped_file_view is a read-only, contiguous view of the bytes of a file,
+// mapped into memory with mmap (POSIX only). It owns the mapping, so it is
+// move-only; it can be used directly as the V of split_view or
+// contiguous_split_view (an lvalue has to be passed as std::ranges::ref_view),
+// and the resulting segments point into the mapping.
+// No copy of the file is made, and since the mapped pages are clean and
+// file-backed the kernel can reclaim them at any time; evict() additionally
+// lets a caller that has finished with a prefix of the file drop it eagerly,
+// which keeps the resident size bounded when scanning very large files.
+// An empty file yields an empty view. Failures to open, stat or map the file
+// throw std::system_error.
+class mapped_file_view : public std::ranges::view_interface<mapped_file_view> {
+    static constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    [[noreturn]] static void fail(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static void* map(int fd, std::size_t size, bool align) {
+        if (!align) {
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+        // Reserve enough address space to place the file on an aligned
+        // address, map it there, then give back the unused head and tail.
+        const std::size_t reserved = size + huge_page_size;
+        void* r = ::mmap(nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (r == MAP_FAILED)
+            return nullptr;
+        const auto base = reinterpret_cast<std::uintptr_t>(r);
+        const auto aligned = (base + huge_page_size - 1) & ~(huge_page_size - 1);
+        void* p = ::mmap(reinterpret_cast<void*>(aligned), size, PROT_READ,
+            MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (p == MAP_FAILED) {
+            const int e = errno;
+            ::munmap(r, reserved);
+            errno = e;
+            return nullptr;
+        }
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const auto map_end = (aligned + size + page - 1) & ~(page - 1);
+        if (aligned != base)
+            ::munmap(r, aligned - base);
+        if (map_end != base + reserved)
+            ::munmap(reinterpret_cast<void*>(map_end), base + reserved - map_end);
+        return p;
+    }
+
+    void unmap() noexcept {
+        if (data_)
+            ::munmap(const_cast<char*>(data_), size_);
+    }
+public:
+    mapped_file_view() = default;
+
+    explicit mapped_file_view(const std::filesystem::path& path,
+        mapped_file_options options = {})
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            (fail)("mapped_file_view: open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int e = errno;
+            ::close(fd);
+            errno = e;
+            (fail)("mapped_file_view: fstat");
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return;
+        }
+        void* p = (map)(fd, size_, options.huge_pages);
+        const int e = errno;
+        ::close(fd);
+        if (!p) {
+            errno = e;
+            (fail)("mapped_file_view: mmap");
+        }
+        data_ = static_cast<const char*>(p);
+
+        // The hints are advisory; failing to apply them is not an error.
+        if (options.sequential)
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+        if (options.willneed)
+            ::madvise(p, size_, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+        if (options.huge_pages)
+            ::madvise(p, size_, MADV_HUGEPAGE);
+#endif
+    }
+
+    mapped_file_view(mapped_file_view&& that) noexcept
+        : data_(std::exchange(that.data_, nullptr)), size_(std::exchange(that.size_, 0)) {}
+
+    mapped_file_view& operator=(mapped_file_view&& that) noexcept {
+        if (this != &that) {
+            unmap();
+            data_ = std::exchange(that.data_, nullptr);
+            size_ = std::exchange(that.size_, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_file_view() { unmap(); }
+
+    const char* begin() const noexcept { return data_; }
+    const char* end() const noexcept { return data_ + size_; }
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+    // Tells the kernel that the whole pages within [first, last) are no
+    // longer needed. They are dropped from the process's resident set and
+    // transparently read back from the file if accessed again.
+    void evict(const char* first, const char* last) const noexcept {
+        const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+        const auto b = (reinterpret_cast<std::uintptr_t>(first) + page - 1) & ~(page - 1);
+        const auto e = reinterpret_cast<std::uintptr_t>(last) & ~(page - 1);
+        if (b < e)
+            ::madvise(reinterpret_cast<void*>(b), e - b, MADV_DONTNEED);
+    }
+};
+
+template<>
+struct contiguous_segment<mapped_file_view> {
+    using type = std::string_view;
+};
+template<>
+struct contiguous_segment<std::ranges::ref_view<mapped_file_view>> {
+    using type = std::string_view;
+};
+template<>
+struct contiguous_segment<std::ranges::ref_view<const mapped_file_view>> {
+    using type = std::string_view;
+};
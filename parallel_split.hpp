@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<std::ranges::contiguous_range R, std::ranges::random_access_range P>
+    std::vector<segment_bounds> parallel_split_index(const R& r, const P& pattern,
+        unsigned threads = 0);
+    template<std::ranges::contiguous_range R>
+    std::vector<segment_bounds> parallel_split_index(const R& r,
+        std::ranges::range_value_t<R> e, unsigned threads = 0);
+
+    template<std::ranges::contiguous_range R, std::ranges::random_access_range P, class F>
+    void parallel_split(const R& r, const P& pattern, F&& f, unsigned threads = 0);
+    template<std::ranges::contiguous_range R, class F>
+    void parallel_split(const R& r, std::ranges::range_value_t<R> e, F&& f,
+        unsigned threads = 0);
+*/
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "contiguous_split_view.hpp"
+#include "invoke.hpp"
+#include "segment_index.hpp"
+#include "split_view.hpp"
+#include "two_way_searcher.hpp"
+
+// Chunks smaller than this are not worth a thread of their own.
+inline constexpr std::size_t parallel_split_min_chunk = std::size_t(1) << 20;
+
+// parallel_split_index(r, pattern, threads) returns the bounds of the
+// segments split_view(r, pattern) produces, in order.
+// r is divided into up to threads chunks (std::thread::hardware_concurrency()
+// if threads is 0) which are scanned concurrently with one searcher (see pattern_searcher).
+// Each chunk collects the greedy, non-overlapping occurrences that start in
+// it, reading up to size(pattern) - 1 elements past its end so that
+// occurrences straddling a chunk boundary are found by the chunk in which
+// they start. The chunks are then merged in order: if the previous chunk's
+// last occurrence extends into a chunk, the chunk is rescanned from the end of
+// that occurrence until the rescan meets one of the chunk's own occurrences,
+// from which point on both agree.
+template<std::ranges::contiguous_range R, std::ranges::random_access_range P>
+requires std::ranges::sized_range<P> &&
+         std::totally_ordered<std::ranges::range_value_t<P>> &&
+         std::indirectly_comparable<std::ranges::iterator_t<const R>,
+             std::ranges::iterator_t<const P>, std::ranges::equal_to>
+std::vector<segment_bounds> parallel_split_index(const R& r, const P& pattern,
+    unsigned threads = 0)
+{
+    const auto data = std::ranges::data(r);
+    const auto n = static_cast<std::size_t>(std::ranges::distance(r));
+    const auto m = static_cast<std::size_t>(std::ranges::size(pattern));
+    std::vector<segment_bounds> result;
+    if (m == 0) {
+        result.reserve(n);
+        for (std::size_t i = 0; i != n; ++i)
+            result.push_back({ i, i + 1 });
+        return result;
+    }
+
+    const typename pattern_searcher<P>::type searcher(pattern);
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t chunks = std::clamp<std::size_t>(n / parallel_split_min_chunk, 1, threads);
+    const auto chunk_begin = [&](std::size_t k) { return n / chunks * k + std::min(k, n % chunks); };
+    const auto chunk_limit = [&](std::size_t k) { return std::min(n, chunk_begin(k + 1) + m - 1); };
+    // Returns the first occurrence at or after pos that starts in chunk k,
+    // or n if there is none.
+    const auto find = [&](std::size_t k, std::size_t pos) -> std::size_t {
+        const auto limit = chunk_limit(k);
+        if (pos >= limit)
+            return n;
+        const auto match = searcher(data + pos, data + limit, pattern);
+        const auto s = static_cast<std::size_t>(match.begin() - data);
+        return s < chunk_begin(k + 1) ? s : n;
+    };
+
+    std::vector<std::vector<std::size_t>> matches(chunks);
+    const auto scan = [&](std::size_t k) {
+        for (auto s = (find)(k, chunk_begin(k)); s != n; s = (find)(k, s + m))
+            matches[k].push_back(s);
+    };
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks - 1);
+    for (std::size_t k = 1; k < chunks; ++k)
+        futures.push_back(std::async(std::launch::async, scan, k));
+    scan(0);
+    for (auto& f : futures)
+        f.get();
+
+    std::size_t start = 0;
+    for (std::size_t k = 0; k != chunks; ++k) {
+        const auto& ms = matches[k];
+        auto i = ms.begin();
+        if (start > chunk_begin(k)) {
+            i = std::lower_bound(ms.begin(), ms.end(), start);
+            auto s = (find)(k, start);
+            while (s != n && (i == ms.end() || s != *i)) {
+                result.push_back({ start, s });
+                start = s + m;
+                i = std::lower_bound(i, ms.end(), start);
+                s = (find)(k, start);
+            }
+            if (s == n)
+                continue;
+        }
+        for (; i != ms.end(); ++i) {
+            result.push_back({ start, *i });
+            start = *i + m;
+        }
+    }
+    if (start != n)
+        result.push_back({ start, n });
+    return result;
+}
+
+template<std::ranges::contiguous_range R>
+std::vector<segment_bounds> parallel_split_index(const R& r,
+    std::ranges::range_value_t<R> e, unsigned threads = 0)
+{
+    return (parallel_split_index)(r, std::ranges::single_view{std::move(e)}, threads);
+}
+
+// parallel_split(r, pattern, f, threads) calls f with each segment of
+// split_view(r, pattern), in order and on the calling thread, after
+// computing the segment bounds with parallel_split_index. The segments are
+// passed as contiguous_segment<std::views::all_t<const R&>>::type.
+template<std::ranges::contiguous_range R, std::ranges::random_access_range P, class F>
+void parallel_split(const R& r, const P& pattern, F&& f, unsigned threads = 0) {
+    using segment_type = typename contiguous_segment<std::views::all_t<const R&>>::type;
+    const auto data = std::ranges::data(r);
+    for (const auto& b : (parallel_split_index)(r, pattern, threads))
+        (invoke)(f, segment_type(data + b.begin, b.end - b.begin));
+}
+
+template<std::ranges::contiguous_range R, class F>
+void parallel_split(const R& r, std::ranges::range_value_t<R> e, F&& f,
+    unsigned threads = 0)
+{
+    (parallel_split)(r, std::ranges::single_view{std::move(e)}, static_cast<F&&>(f), threads);
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<std::ranges::contiguous_range V, std::ranges::forward_range Pattern>
+    class rsplit_view {
+    public:
+        using segment_type = typename contiguous_segment<V>::type;
+
+        rsplit_view() = default;
+        constexpr rsplit_view(V base, Pattern pattern,
+            std::size_t max_splits = std::size_t(-1));
+        template<std::ranges::input_range R>
+        constexpr rsplit_view(R&& r, std::ranges::range_value_t<R> e,
+            std::size_t max_splits = std::size_t(-1));
+
+        constexpr V base() const&;
+        constexpr V base() &&;
+
+        constexpr iterator begin() const;
+        constexpr iterator end() const;
+    };
+*/
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_split_view.hpp"
+#include "two_way_searcher.hpp"
+
+// An rsplit_view produces the segments of a contiguous range from the last
+// to the first, searching for the pattern backwards from the end of the
+// base, so reading the last few segments touches only the elements they
+// span. A trailing pattern does not start a final empty segment, so for
+// patterns that cannot overlap themselves (e.g. any single element) the
+// segments are those of the corresponding split_view, in reverse order.
+// Otherwise the matches are the rightmost ones: splitting "aaab" on "aa"
+// gives "b" then "a" where split_view gives "" then "ab".
+// With max_splits, at most that many matches are searched for and the rest
+// of the base, unscanned, is the last (i.e. leftmost) segment; a dropped
+// trailing match is one of them, and with max_splits 0 the whole base is
+// the only segment, as with contiguous_split_view.
+// The backward search is the view's two_way_searcher, built for the reversed
+// pattern and run over reverse_iterators, which for a single element uses
+// simd_rfind; a single_element_pattern gets an element_searcher instead,
+// which needs no state.
+// The iterator is a forward iterator whose reference type is segment_type.
+template<std::ranges::contiguous_range V, std::ranges::forward_range Pattern>
+requires std::ranges::view<V> && std::ranges::view<Pattern> &&
+         std::ranges::contiguous_range<const V> && std::ranges::common_range<const V> &&
+         two_way_searchable<Pattern> && std::ranges::common_range<const Pattern> &&
+         std::indirectly_comparable<std::ranges::iterator_t<const V>,
+             std::ranges::iterator_t<const Pattern>, std::ranges::equal_to>
+class rsplit_view : public std::ranges::view_interface<rsplit_view<V, Pattern>> {
+public:
+    using segment_type = typename contiguous_segment<V>::type;
+private:
+    [[no_unique_address]] V base_ = V();
+    [[no_unique_address]] Pattern pattern_ = Pattern();
+    [[no_unique_address]]
+    std::conditional_t<single_element_pattern<Pattern>,
+        element_searcher<std::ranges::range_value_t<Pattern>>,
+        two_way_searcher<std::ranges::range_value_t<Pattern>>> searcher_;
+    std::size_t max_splits_ = std::size_t(-1);
+
+    using I = std::ranges::iterator_t<const V>;
+
+    constexpr auto reversed_pattern_() const { return std::views::reverse(pattern_); }
+
+    struct iterator {
+    private:
+        friend rsplit_view;
+
+        const rsplit_view* parent_ = nullptr;
+        I seg_begin_ = I();
+        I seg_end_ = I();
+        I next_end_ = I();
+        std::size_t splits_ = 0;
+        bool last_ = true;
+        bool done_ = true;
+
+        constexpr iterator(const rsplit_view& parent, I seg_end, bool done)
+            : parent_(std::addressof(parent)), seg_begin_(seg_end), seg_end_(seg_end),
+              next_end_(seg_end), done_(done) {}
+
+        // Finds the start of the segment ending at seg_end_ and the end of
+        // the preceding one.
+        constexpr void find_() {
+            const auto begin = std::ranges::begin(parent_->base_);
+            last_ = true;
+            seg_begin_ = begin;
+            if (seg_end_ == begin || splits_ == parent_->max_splits_)
+                return;
+            if (std::ranges::empty(parent_->pattern_)) {
+                seg_begin_ = next_end_ = std::ranges::prev(seg_end_);
+                last_ = seg_begin_ == begin;
+                return;
+            }
+            const auto pattern = parent_->reversed_pattern_();
+            const auto match = parent_->searcher_(std::make_reverse_iterator(seg_end_),
+                std::make_reverse_iterator(begin), pattern);
+            if (match.begin() != std::make_reverse_iterator(begin)) {
+                seg_begin_ = match.begin().base();
+                next_end_ = match.end().base();
+                last_ = false;
+            }
+        }
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = segment_type;
+        using difference_type = std::ranges::range_difference_t<const V>;
+
+        iterator() = default;
+
+        constexpr segment_type operator*() const {
+            return segment_type(std::to_address(seg_begin_),
+                static_cast<std::size_t>(seg_end_ - seg_begin_));
+        }
+
+        constexpr iterator& operator++() {
+            if (last_) {
+                done_ = true;
+                seg_begin_ = seg_end_ = next_end_ = std::ranges::begin(parent_->base_);
+                return *this;
+            }
+            seg_end_ = next_end_;
+            ++splits_;
+            find_();
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& x, const iterator& y) {
+            return x.done_ == y.done_ && x.seg_end_ == y.seg_end_;
+        }
+        friend constexpr bool operator==(const iterator& x, std::default_sentinel_t) {
+            return x.done_;
+        }
+    };
+
+public:
+    rsplit_view() = default;
+    constexpr rsplit_view(V base, Pattern pattern, std::size_t max_splits = std::size_t(-1))
+        : base_(std::move(base)), pattern_(std::move(pattern)),
+          searcher_(reversed_pattern_()), max_splits_(max_splits) {}
+
+    template<std::ranges::input_range R>
+    requires std::constructible_from<V, std::views::all_t<R>> &&
+             std::constructible_from<Pattern,
+                 std::ranges::single_view<std::ranges::range_value_t<R>>>
+    constexpr rsplit_view(R&& r, std::ranges::range_value_t<R> e,
+                          std::size_t max_splits = std::size_t(-1))
+        : base_(std::views::all(std::forward<R>(r))),
+          pattern_(std::ranges::single_view{std::move(e)}),
+          searcher_(reversed_pattern_()), max_splits_(max_splits) {}
+
+    constexpr V base() const& requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr iterator begin() const {
+        const auto first = std::ranges::begin(base_);
+        auto last = std::ranges::end(base_);
+        if (first == last)
+            return end();
+        // Drop a trailing match, as split_view drops the empty segment
+        // after it; it counts as one of the max_splits matches.
+        const auto m = std::ranges::distance(pattern_);
+        bool dropped = false;
+        if (max_splits_ != 0 && m != 0 && last - first >= m &&
+            std::ranges::equal(last - m, last, std::ranges::begin(pattern_),
+                std::ranges::end(pattern_)))
+        {
+            last -= m;
+            dropped = true;
+        }
+        iterator it{*this, last, false};
+        it.splits_ = dropped;
+        it.find_();
+        return it;
+    }
+    constexpr iterator end() const {
+        return iterator{*this, std::ranges::begin(base_), true};
+    }
+};
+
+template<class R, class P>
+rsplit_view(R&&, P&&) -> rsplit_view<std::views::all_t<R>, std::views::all_t<P>>;
+
+template<std::ranges::input_range R>
+rsplit_view(R&&, std::ranges::range_value_t<R>)
+    -> rsplit_view<std::views::all_t<R>,
+        std::ranges::single_view<std::ranges::range_value_t<R>>>;
+
+template<class R, class P>
+rsplit_view(R&&, P&&, std::size_t)
+    -> rsplit_view<std::views::all_t<R>, std::views::all_t<P>>;
+
+template<std::ranges::input_range R>
+rsplit_view(R&&, std::ranges::range_value_t<R>, std::size_t)
+    -> rsplit_view<std::views::all_t<R>,
+        std::ranges::single_view<std::ranges::range_value_t<R>>>;
@@ -0,0 +1,253 @@
+#pragma once
+
+/*
+    synopsis
+
+    struct segment_bounds {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    template<class Segment>
+    class segment_index {
+    public:
+        using segment_type = Segment;
+        using pointer = decltype(std::ranges::data(std::declval<Segment&>()));
+
+        segment_index() = default;
+        template<std::ranges::input_range R>
+        segment_index(pointer base, R&& segments);
+
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+        segment_bounds bounds(std::size_t i) const noexcept;
+        Segment operator[](std::size_t i) const noexcept;
+
+        iterator begin() const noexcept;
+        iterator end() const noexcept;
+    };
+
+    template<std::ranges::forward_range SplitView>
+    requires std::ranges::borrowed_range<decltype(std::declval<SplitView>().base())> ||
+             std::is_lvalue_reference_v<SplitView>
+    auto make_segment_index(SplitView&& v);
+*/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "contiguous_split_view.hpp"
+
+// The offsets of a segment within the split range: [begin, end).
+struct segment_bounds {
+    std::size_t begin;
+    std::size_t end;
+
+    friend bool operator==(const segment_bounds&, const segment_bounds&) = default;
+};
+
+// A segment_index records the bounds of the segments of a split range so
+// that the segments can be counted and accessed by position in O(1) without
+// splitting the range again.
+// The bounds are stored in blocks of 64 segments. Each block stores the
+// absolute begin offset of its first segment; each segment stores its begin
+// offset relative to that anchor and its length, each packed into the
+// smallest of 1, 2, 4 or 8 bytes that fits every value of the block. For
+// typical line- or field-sized segments this takes about 3 bytes per segment
+// instead of the 16 bytes of a segment_bounds.
+// Segment is the type of the segments to produce, e.g. std::string_view or
+// std::span<const int>; it is constructed from a pointer into the split
+// range and a size.
+template<class Segment>
+class segment_index {
+public:
+    using segment_type = Segment;
+    using pointer = decltype(std::ranges::data(std::declval<Segment&>()));
+private:
+    static constexpr std::size_t block_size = 64;
+
+    struct block {
+        std::uint64_t anchor;
+        std::uint64_t data;
+        std::uint8_t begin_width;
+        std::uint8_t length_width;
+    };
+
+    pointer base_ = nullptr;
+    std::size_t size_ = 0;
+    std::vector<block> blocks_;
+    std::vector<unsigned char> data_;
+
+    static std::uint8_t width(std::uint64_t max) noexcept {
+        return max <= 0xff ? 1 : max <= 0xffff ? 2 : max <= 0xffffffff ? 4 : 8;
+    }
+
+    static std::uint64_t load(const unsigned char* p, std::uint8_t w) noexcept {
+        switch (w) {
+        case 1: return *p;
+        case 2: { std::uint16_t v; std::memcpy(&v, p, 2); return v; }
+        case 4: { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+        default: { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+        }
+    }
+
+    void store(std::uint64_t v, std::uint8_t w) {
+        unsigned char bytes[8];
+        switch (w) {
+        case 1: bytes[0] = static_cast<unsigned char>(v); break;
+        case 2: { auto u = static_cast<std::uint16_t>(v); std::memcpy(bytes, &u, 2); break; }
+        case 4: { auto u = static_cast<std::uint32_t>(v); std::memcpy(bytes, &u, 4); break; }
+        default: std::memcpy(bytes, &v, 8); break;
+        }
+        data_.insert(data_.end(), bytes, bytes + w);
+    }
+
+    void flush(const segment_bounds* first, std::size_t n) {
+        const std::uint64_t anchor = first[0].begin;
+        std::uint64_t max_begin = 0, max_length = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            max_begin = std::max<std::uint64_t>(max_begin, first[i].begin - anchor);
+            max_length = std::max<std::uint64_t>(max_length, first[i].end - first[i].begin);
+        }
+        const block b{ anchor, data_.size(), (width)(max_begin), (width)(max_length) };
+        blocks_.push_back(b);
+        for (std::size_t i = 0; i != n; ++i)
+            store(first[i].begin - anchor, b.begin_width);
+        for (std::size_t i = 0; i != n; ++i)
+            store(first[i].end - first[i].begin, b.length_width);
+    }
+
+    struct iterator {
+    private:
+        const segment_index* parent_ = nullptr;
+        std::ptrdiff_t i_ = 0;
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Segment;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        constexpr iterator(const segment_index& parent, std::ptrdiff_t i) noexcept
+            : parent_(std::addressof(parent)), i_(i) {}
+
+        Segment operator*() const noexcept { return (*parent_)[static_cast<std::size_t>(i_)]; }
+        Segment operator[](difference_type n) const noexcept {
+            return (*parent_)[static_cast<std::size_t>(i_ + n)];
+        }
+
+        constexpr iterator& operator++() noexcept { ++i_; return *this; }
+        constexpr iterator operator++(int) noexcept { auto tmp = *this; ++i_; return tmp; }
+        constexpr iterator& operator--() noexcept { --i_; return *this; }
+        constexpr iterator operator--(int) noexcept { auto tmp = *this; --i_; return tmp; }
+        constexpr iterator& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+        constexpr iterator& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+
+        friend constexpr iterator operator+(iterator i, difference_type n) noexcept { return i += n; }
+        friend constexpr iterator operator+(difference_type n, iterator i) noexcept { return i += n; }
+        friend constexpr iterator operator-(iterator i, difference_type n) noexcept { return i -= n; }
+        friend constexpr difference_type operator-(const iterator& x, const iterator& y) noexcept {
+            return x.i_ - y.i_;
+        }
+        friend constexpr bool operator==(const iterator& x, const iterator& y) noexcept {
+            return x.i_ == y.i_;
+        }
+        friend constexpr auto operator<=>(const iterator& x, const iterator& y) noexcept {
+            return x.i_ <=> y.i_;
+        }
+    };
+public:
+    segment_index() = default;
+
+    // Builds the index in one pass over segments, whose elements are either
+    // segment_bounds relative to base or contiguous ranges pointing into
+    // the range that starts at base, such as the segments of a
+    // contiguous_split_view.
+    template<std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, segment_bounds> ||
+             std::ranges::contiguous_range<std::ranges::range_reference_t<R>>
+    segment_index(pointer base, R&& segments) : base_(base) {
+        segment_bounds pending[block_size];
+        std::size_t n = 0;
+        for (auto&& s : segments) {
+            if constexpr (std::convertible_to<decltype(s), segment_bounds>)
+                pending[n++] = s;
+            else {
+                const auto b = static_cast<std::size_t>(std::ranges::data(s) - base);
+                pending[n++] = { b, b + static_cast<std::size_t>(std::ranges::size(s)) };
+            }
+            if (n == block_size) {
+                flush(pending, n);
+                size_ += n;
+                n = 0;
+            }
+        }
+        if (n != 0) {
+            flush(pending, n);
+            size_ += n;
+        }
+        blocks_.shrink_to_fit();
+        data_.shrink_to_fit();
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    segment_bounds bounds(std::size_t i) const noexcept {
+        const block& b = blocks_[i / block_size];
+        const std::size_t n = i / block_size + 1 == blocks_.size()
+            ? size_ - i / block_size * block_size : block_size;
+        const std::size_t k = i % block_size;
+        const unsigned char* p = data_.data() + b.data;
+        const std::size_t begin = b.anchor + (load)(p + k * b.begin_width, b.begin_width);
+        const std::size_t length =
+            (load)(p + n * b.begin_width + k * b.length_width, b.length_width);
+        return { begin, begin + length };
+    }
+
+    Segment operator[](std::size_t i) const noexcept {
+        const auto b = bounds(i);
+        return Segment(base_ + b.begin, b.end - b.begin);
+    }
+
+    iterator begin() const noexcept { return iterator(*this, 0); }
+    iterator end() const noexcept { return iterator(*this, static_cast<std::ptrdiff_t>(size_)); }
+};
+
+// make_segment_index(v) builds a segment_index from a split view over a
+// contiguous range in one pass over v. v is either a view whose segments
+// are contiguous, such as contiguous_split_view or split_any_view, or a
+// split_view, whose segments are walked through to find where they end.
+// The segments are located relative to std::ranges::data(v.base()), so
+// v.base() must refer to the elements v splits, as a copy of a borrowed
+// range does. The index points into those elements, so v may only be an
+// rvalue if its base is a borrowed range, whose elements outlive v.
+template<std::ranges::forward_range SplitView>
+requires std::ranges::borrowed_range<decltype(std::declval<SplitView>().base())> ||
+         std::is_lvalue_reference_v<SplitView>
+auto make_segment_index(SplitView&& v) {
+    using base_type = decltype(std::move(v).base());
+    constexpr bool contiguous =
+        std::ranges::contiguous_range<std::ranges::range_reference_t<SplitView>>;
+    const auto base = std::ranges::data(v.base());
+    if constexpr (contiguous) {
+        return segment_index<std::ranges::range_value_t<SplitView>>(base, v);
+    } else {
+        using Segment = typename contiguous_segment<base_type>::type;
+        return segment_index<Segment>(base,
+            std::ranges::ref_view(v) | std::views::transform([base](auto seg) {
+                auto it = std::ranges::begin(seg);
+                const auto b = static_cast<std::size_t>(std::to_address(it.base()) - base);
+                for (const auto e = std::ranges::end(seg); it != e; ++it) {}
+                return segment_bounds{ b,
+                    static_cast<std::size_t>(std::to_address(it.base()) - base) };
+            }));
+    }
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class T>
+    concept simd_findable;
+
+    template<simd_findable T>
+    const T* simd_find(const T* first, const T* last, T value) noexcept;
+
+    template<simd_findable T>
+    const T* simd_rfind(const T* first, const T* last, T value) noexcept;
+*/
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#define SIMD_FIND_X86 1
+#include <immintrin.h>
+#endif
+
+// Element types for which equality is the same as bitwise equality and which
+// fit in a SIMD lane of 1, 2 or 4 bytes, e.g. char, char8_t, std::byte,
+// std::uint16_t, char32_t.
+template<class T>
+concept simd_findable = (std::is_integral_v<T> || std::is_enum_v<T>) &&
+    std::has_unique_object_representations_v<T> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4);
+
+template<class T>
+constexpr const T* scalar_find(const T* first, const T* last, T value) noexcept {
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+}
+
+template<class T>
+constexpr const T* scalar_rfind(const T* first, const T* last, T value) noexcept {
+    for (auto p = last; p != first;)
+        if (*--p == value)
+            return p;
+    return last;
+}
+
+#ifdef SIMD_FIND_X86
+#if defined(__GNUC__)
+#define SIMD_FIND_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_FIND_TARGET_AVX2
+#endif
+
+template<std::size_t Size>
+struct simd_find_lanes; // not defined
+
+template<>
+struct simd_find_lanes<1> {
+    static __m128i splat(std::uint8_t v) noexcept { return _mm_set1_epi8(static_cast<char>(v)); }
+    static __m128i eq(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi8(a, b); }
+    SIMD_FIND_TARGET_AVX2
+    static __m256i splat256(std::uint8_t v) noexcept { return _mm256_set1_epi8(static_cast<char>(v)); }
+    SIMD_FIND_TARGET_AVX2
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+};
+template<>
+struct simd_find_lanes<2> {
+    static __m128i splat(std::uint16_t v) noexcept { return _mm_set1_epi16(static_cast<short>(v)); }
+    static __m128i eq(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi16(a, b); }
+    SIMD_FIND_TARGET_AVX2
+    static __m256i splat256(std::uint16_t v) noexcept { return _mm256_set1_epi16(static_cast<short>(v)); }
+    SIMD_FIND_TARGET_AVX2
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+};
+template<>
+struct simd_find_lanes<4> {
+    static __m128i splat(std::uint32_t v) noexcept { return _mm_set1_epi32(static_cast<int>(v)); }
+    static __m128i eq(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi32(a, b); }
+    SIMD_FIND_TARGET_AVX2
+    static __m256i splat256(std::uint32_t v) noexcept { return _mm256_set1_epi32(static_cast<int>(v)); }
+    SIMD_FIND_TARGET_AVX2
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+};
+
+template<class T>
+using simd_find_uint = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+    std::conditional_t<sizeof(T) == 2, std::uint16_t, std::uint32_t>>;
+
+inline unsigned simd_find_ctz(std::uint32_t mask) noexcept {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return static_cast<unsigned>(i);
+#endif
+}
+
+// Returns the index of the highest set bit of mask.
+inline unsigned simd_find_bsr(std::uint32_t mask) noexcept {
+#if defined(__GNUC__)
+    return 31 - static_cast<unsigned>(__builtin_clz(mask));
+#else
+    unsigned long i;
+    _BitScanReverse(&i, mask);
+    return static_cast<unsigned>(i);
+#endif
+}
+
+// Each of the following functions returns the first match in [first, last)
+// or last. None of them reads outside of [first, last): the final partial
+// block is handled by an overlapping load ending at last, whose lanes before
+// the current position are already known not to match.
+template<class T>
+const T* sse2_find(const T* first, const T* last, T value) noexcept {
+    using L = simd_find_lanes<sizeof(T)>;
+    constexpr std::ptrdiff_t n = 16 / sizeof(T);
+    if (last - first < n)
+        return (scalar_find)(first, last, value);
+    const __m128i v = L::splat(static_cast<simd_find_uint<T>>(value));
+    for (; last - first >= n; first += n) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        if (const auto m = static_cast<std::uint32_t>(_mm_movemask_epi8(L::eq(x, v))))
+            return first + (simd_find_ctz)(m) / sizeof(T);
+    }
+    if (first == last)
+        return last;
+    first = last - n;
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    if (const auto m = static_cast<std::uint32_t>(_mm_movemask_epi8(L::eq(x, v))))
+        return first + (simd_find_ctz)(m) / sizeof(T);
+    return last;
+}
+
+// The reverse searches mirror the forward ones: they return the last match
+// in [first, last) or last, walk blocks from last down to first and finish
+// with an overlapping load starting at first.
+template<class T>
+const T* sse2_rfind(const T* first, const T* last, T value) noexcept {
+    using L = simd_find_lanes<sizeof(T)>;
+    constexpr std::ptrdiff_t n = 16 / sizeof(T);
+    if (last - first < n)
+        return (scalar_rfind)(first, last, value);
+    const T* const end = last;
+    const __m128i v = L::splat(static_cast<simd_find_uint<T>>(value));
+    for (; last - first >= n; last -= n) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last - n));
+        if (const auto m = static_cast<std::uint32_t>(_mm_movemask_epi8(L::eq(x, v))))
+            return last - n + (simd_find_bsr)(m) / sizeof(T);
+    }
+    if (first == last)
+        return end;
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    if (const auto m = static_cast<std::uint32_t>(_mm_movemask_epi8(L::eq(x, v))))
+        return first + (simd_find_bsr)(m) / sizeof(T);
+    return end;
+}
+
+#if defined(__GNUC__)
+template<class T>
+SIMD_FIND_TARGET_AVX2
+const T* avx2_find(const T* first, const T* last, T value) noexcept {
+    using L = simd_find_lanes<sizeof(T)>;
+    constexpr std::ptrdiff_t n = 32 / sizeof(T);
+    if (last - first < n)
+        return (sse2_find)(first, last, value);
+    const __m256i v = L::splat256(static_cast<simd_find_uint<T>>(value));
+    const auto match = [&v](const T* p) SIMD_FIND_TARGET_AVX2 {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(L::eq(x, v)));
+    };
+    // The main loop tests four vectors per iteration and only locates the
+    // match once one of them hits.
+    for (; last - first >= 4 * n; first += 4 * n) {
+        const auto* const p = reinterpret_cast<const __m256i*>(first);
+        const __m256i e0 = L::eq(_mm256_loadu_si256(p + 0), v);
+        const __m256i e1 = L::eq(_mm256_loadu_si256(p + 1), v);
+        const __m256i e2 = L::eq(_mm256_loadu_si256(p + 2), v);
+        const __m256i e3 = L::eq(_mm256_loadu_si256(p + 3), v);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+        if (_mm256_testz_si256(any, any))
+            continue;
+        for (int i = 0; i != 4; ++i)
+            if (const auto m = match(first + i * n))
+                return first + i * n + (simd_find_ctz)(m) / sizeof(T);
+    }
+    for (; last - first >= n; first += n)
+        if (const auto m = match(first))
+            return first + (simd_find_ctz)(m) / sizeof(T);
+    if (first == last)
+        return last;
+    first = last - n;
+    if (const auto m = match(first))
+        return first + (simd_find_ctz)(m) / sizeof(T);
+    return last;
+}
+
+template<class T>
+SIMD_FIND_TARGET_AVX2
+const T* avx2_rfind(const T* first, const T* last, T value) noexcept {
+    using L = simd_find_lanes<sizeof(T)>;
+    constexpr std::ptrdiff_t n = 32 / sizeof(T);
+    if (last - first < n)
+        return (sse2_rfind)(first, last, value);
+    const T* const end = last;
+    const __m256i v = L::splat256(static_cast<simd_find_uint<T>>(value));
+    const auto match = [&v](const T* p) SIMD_FIND_TARGET_AVX2 {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(L::eq(x, v)));
+    };
+    for (; last - first >= 4 * n; last -= 4 * n) {
+        const auto* const p = reinterpret_cast<const __m256i*>(last - 4 * n);
+        const __m256i e0 = L::eq(_mm256_loadu_si256(p + 0), v);
+        const __m256i e1 = L::eq(_mm256_loadu_si256(p + 1), v);
+        const __m256i e2 = L::eq(_mm256_loadu_si256(p + 2), v);
+        const __m256i e3 = L::eq(_mm256_loadu_si256(p + 3), v);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+        if (_mm256_testz_si256(any, any))
+            continue;
+        for (int i = 1; i != 5; ++i)
+            if (const auto m = match(last - i * n))
+                return last - i * n + (simd_find_bsr)(m) / sizeof(T);
+    }
+    for (; last - first >= n; last -= n)
+        if (const auto m = match(last - n))
+            return last - n + (simd_find_bsr)(m) / sizeof(T);
+    if (first == last)
+        return end;
+    if (const auto m = match(first))
+        return first + (simd_find_bsr)(m) / sizeof(T);
+    return end;
+}
+
+inline bool simd_find_has_avx2() noexcept {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+
+inline bool simd_find_has_ssse3() noexcept {
+    static const bool has = __builtin_cpu_supports("ssse3");
+    return has;
+}
+#endif
+#endif
+
+// Returns a pointer to the first element of [first, last) that equals value,
+// or last if there is none. On x86, the search uses AVX2 if the CPU supports
+// it (detected at run time) and SSE2 otherwise; on other targets it is a
+// plain loop.
+template<simd_findable T>
+const T* simd_find(const T* first, const T* last, T value) noexcept {
+#ifdef SIMD_FIND_X86
+#if defined(__GNUC__)
+    if ((simd_find_has_avx2)())
+        return (avx2_find)(first, last, value);
+#endif
+    return (sse2_find)(first, last, value);
+#else
+    return (scalar_find)(first, last, value);
+#endif
+}
+
+// Returns a pointer to the last element of [first, last) that equals value,
+// or last if there is none; dispatches like simd_find.
+template<simd_findable T>
+const T* simd_rfind(const T* first, const T* last, T value) noexcept {
+#ifdef SIMD_FIND_X86
+#if defined(__GNUC__)
+    if ((simd_find_has_avx2)())
+        return (avx2_rfind)(first, last, value);
+#endif
+    return (sse2_rfind)(first, last, value);
+#else
+    return (scalar_rfind)(first, last, value);
+#endif
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+/*
+    synopsis
+
+    struct collapse_delimiters_t {
+        explicit collapse_delimiters_t() = default;
+    };
+    inline constexpr collapse_delimiters_t collapse_delimiters{};
+
+    template<std::ranges::contiguous_range V>
+    class split_any_view {
+    public:
+        using segment_type = typename contiguous_segment<V>::type;
+
+        split_any_view() = default;
+        constexpr split_any_view(V base, delimiter_set delims);
+        constexpr split_any_view(collapse_delimiters_t, V base, delimiter_set delims);
+
+        constexpr V base() const&;
+        constexpr V base() &&;
+
+        constexpr iterator begin() const;
+        constexpr iterator end() const;
+    };
+*/
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_split_view.hpp"
+#include "delimiter_set.hpp"
+#include "simd_find.hpp"
+
+struct collapse_delimiters_t {
+    explicit collapse_delimiters_t() = default;
+};
+inline constexpr collapse_delimiters_t collapse_delimiters{};
+
+// A split_any_view splits a contiguous range of bytes on every element that
+// is in a delimiter_set, e.g. split_any_view(str, delimiter_set(" \t,;")).
+// By default it produces the segments a split_view would produce if its
+// pattern matched any single delimiter: consecutive delimiters delimit empty
+// segments, and a trailing delimiter does not start a final empty segment.
+// When constructed with collapse_delimiters, each run of delimiters
+// separates two segments and leading delimiters are skipped, so no segment
+// is empty.
+// Like contiguous_split_view, each segment is found once and yielded as a
+// segment_type pointing into the base; the delimiters are located with
+// delimiter_set::find, 16 or 32 bytes at a time.
+template<std::ranges::contiguous_range V>
+requires std::ranges::view<V> &&
+         std::ranges::contiguous_range<const V> && std::ranges::common_range<const V> &&
+         simd_findable<std::ranges::range_value_t<V>> &&
+         (sizeof(std::ranges::range_value_t<V>) == 1)
+class split_any_view : public std::ranges::view_interface<split_any_view<V>> {
+public:
+    using segment_type = typename contiguous_segment<V>::type;
+private:
+    [[no_unique_address]] V base_ = V();
+    delimiter_set delims_;
+    bool collapse_ = false;
+
+    using I = std::ranges::iterator_t<const V>;
+
+    struct iterator {
+    private:
+        friend split_any_view;
+
+        const split_any_view* parent_ = nullptr;
+        I cur_ = I();
+        I seg_end_ = I();
+        I next_ = I();
+
+        constexpr iterator(const split_any_view& parent, I cur)
+            : parent_(std::addressof(parent)), cur_(cur), seg_end_(cur), next_(cur) {}
+
+        // Returns the first position in [first, end) that is not a
+        // delimiter.
+        constexpr I skip_(I first) const {
+            const auto end = std::ranges::end(parent_->base_);
+            while (first != end && parent_->delims_.contains(*first))
+                ++first;
+            return first;
+        }
+
+        // Finds the end of the segment starting at cur_ and the start of the
+        // following one.
+        constexpr void find_() {
+            const auto end = std::ranges::end(parent_->base_);
+            if (cur_ == end)
+                return;
+            if (std::is_constant_evaluated()) {
+                seg_end_ = cur_;
+                while (seg_end_ != end && !parent_->delims_.contains(*seg_end_))
+                    ++seg_end_;
+            } else {
+                const auto first = std::to_address(cur_);
+                seg_end_ = cur_ + (parent_->delims_.find(first, first + (end - cur_)) - first);
+            }
+            if (seg_end_ == end)
+                next_ = end;
+            else if (parent_->collapse_)
+                next_ = skip_(std::ranges::next(seg_end_));
+            else
+                next_ = std::ranges::next(seg_end_);
+        }
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = segment_type;
+        using difference_type = std::ranges::range_difference_t<const V>;
+
+        iterator() = default;
+
+        constexpr segment_type operator*() const {
+            return segment_type(std::to_address(cur_),
+                static_cast<std::size_t>(seg_end_ - cur_));
+        }
+
+        constexpr iterator& operator++() {
+            cur_ = next_;
+            find_();
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& x, const iterator& y) {
+            return x.cur_ == y.cur_;
+        }
+        friend constexpr bool operator==(const iterator& x, std::default_sentinel_t) {
+            return x.cur_ == std::ranges::end(x.parent_->base_);
+        }
+    };
+
+public:
+    split_any_view() = default;
+    constexpr split_any_view(V base, delimiter_set delims)
+        : base_(std::move(base)), delims_(delims) {}
+    constexpr split_any_view(collapse_delimiters_t, V base, delimiter_set delims)
+        : base_(std::move(base)), delims_(delims), collapse_(true) {}
+
+    constexpr V base() const& requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr iterator begin() const {
+        iterator it{*this, std::ranges::begin(base_)};
+        if (collapse_)
+            it.cur_ = it.skip_(it.cur_);
+        it.find_();
+        return it;
+    }
+    constexpr iterator end() const {
+        return iterator{*this, std::ranges::end(base_)};
+    }
+};
+
+template<class R>
+split_any_view(R&&, delimiter_set) -> split_any_view<std::views::all_t<R>>;
+
+template<class R>
+split_any_view(collapse_delimiters_t, R&&, delimiter_set)
+    -> split_any_view<std::views::all_t<R>>;
@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class S>
+    concept split_stats_policy;
+
+    struct no_split_stats;
+
+    struct split_stats {
+        std::size_t comparisons = 0;
+        std::size_t false_starts = 0;
+        std::size_t advanced = 0;
+        std::size_t searches = 0;
+        std::size_t segments = 0;
+    };
+
+    class counting_split_stats {
+    public:
+        constexpr explicit counting_split_stats(split_stats& stats) noexcept;
+    };
+*/
+#include <concepts>
+#include <cstddef>
+#include <memory>
+
+// A statistics policy of split_view<V, Pattern, Stats> is told, through
+// const member functions, about the work the view's iterators do:
+//  - compared(n): n elements of the base were compared with the pattern
+//    by the view itself (including each time inner_iterator's comparison
+//    with its sentinel compares the pattern again);
+//  - false_start(): a comparison matched a proper, non-empty prefix of the
+//    pattern and then failed;
+//  - advanced(n): an iterator into the base moved n elements forward,
+//    either one at a time or by a search;
+//  - searched(): the view's searcher (see pattern_searcher) was called; the
+//    comparisons made inside a searcher are not reported;
+//  - segment(): the outer iterator moved past a segment.
+// Policies record through a pointer or reference, or forward each event to
+// a callback, since the view may be const and is copied by value.
+template<class S>
+concept split_stats_policy = std::copy_constructible<S> &&
+    requires(const S& s, std::size_t n) {
+        s.compared(n);
+        s.false_start();
+        s.advanced(n);
+        s.searched();
+        s.segment();
+    };
+
+// The default policy, which does nothing and is stored in no space; with it,
+// split_view does no bookkeeping at all.
+struct no_split_stats {
+    constexpr void compared(std::size_t) const noexcept {}
+    constexpr void false_start() const noexcept {}
+    constexpr void advanced(std::size_t) const noexcept {}
+    constexpr void searched() const noexcept {}
+    constexpr void segment() const noexcept {}
+};
+
+template<class S>
+inline constexpr bool split_stats_enabled = !std::same_as<S, no_split_stats>;
+
+// The totals of the events reported to a split_stats_policy.
+struct split_stats {
+    std::size_t comparisons = 0;
+    std::size_t false_starts = 0;
+    std::size_t advanced = 0;
+    std::size_t searches = 0;
+    std::size_t segments = 0;
+};
+
+// A counting_split_stats adds the events of the view it is given to to a
+// split_stats, which outlives the view and all copies of it, e.g.
+//     split_stats stats;
+//     for (auto line : split_view(text, '\n', counting_split_stats(stats))) ...
+class counting_split_stats {
+    split_stats* stats_;
+public:
+    constexpr explicit counting_split_stats(split_stats& stats) noexcept
+        : stats_(std::addressof(stats)) {}
+
+    constexpr void compared(std::size_t n) const noexcept { stats_->comparisons += n; }
+    constexpr void false_start() const noexcept { ++stats_->false_starts; }
+    constexpr void advanced(std::size_t n) const noexcept { stats_->advanced += n; }
+    constexpr void searched() const noexcept { ++stats_->searches; }
+    constexpr void segment() const noexcept { ++stats_->segments; }
+};
@@ -1,10 +1,16 @@
+#pragma once
+
 #include <ranges>
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-template<class F, int = (F(), 0)>
-constexpr bool is_constexpr(F) { return true; }
-constexpr bool is_constexpr(...) { return false; }
+#include "split_stats.hpp"
+#include "two_way_searcher.hpp"
 
 template<class R>
 concept simple_view = std::ranges::view<R> && std::ranges::range<const R> &&
@@ -14,31 +20,127 @@ concept simple_view = std::ranges::view<R> && std::ranges::range<const R> &&
 template<bool Const, class T>
 using maybe_const = std::conditional_t<Const, const T, T>;
 
-template<std::ranges::input_range V, std::ranges::forward_range Pattern>
+// Provides the iterator_category of split_view's inner_iterator, which is
+// only defined for forward ranges.
+template<class Base, bool = std::ranges::forward_range<Base>>
+struct split_inner_iterator_category {};
+template<class Base>
+struct split_inner_iterator_category<Base, true> {
+    using iterator_category = std::conditional_t<
+        std::derived_from<
+            typename std::iterator_traits<std::ranges::iterator_t<Base>>::iterator_category,
+            std::forward_iterator_tag>,
+        std::forward_iterator_tag,
+        typename std::iterator_traits<std::ranges::iterator_t<Base>>::iterator_category>;
+};
+
+// Patterns that can be preprocessed into a two_way_searcher.
+template<class Pattern>
+concept two_way_searchable = std::ranges::random_access_range<const Pattern> &&
+    std::ranges::sized_range<const Pattern> &&
+    std::totally_ordered<std::ranges::range_value_t<Pattern>>;
+
+// Whether split_view<V, Pattern> searches V with its two_way_searcher
+// instead of comparing the pattern at every position.
+template<class V, class Pattern>
+concept two_way_splittable = two_way_searchable<Pattern> &&
+    std::ranges::random_access_range<V> &&
+    std::sized_sentinel_for<std::ranges::sentinel_t<V>, std::ranges::iterator_t<V>>;
+
+// A split_lookahead holds the elements split_view has read ahead from an
+// input range while checking for a multi-element pattern; it never holds
+// more elements than the pattern has. Popped elements are only erased once
+// they outnumber the live ones, so each element is moved O(1) times on
+// average and the storage stays below twice the pattern size.
+template<class T>
+class split_lookahead {
+    std::vector<T> buf_;
+    std::size_t head_ = 0;
+public:
+    constexpr std::size_t size() const noexcept { return buf_.size() - head_; }
+    constexpr T& operator[](std::size_t i) noexcept { return buf_[head_ + i]; }
+    template<class U>
+    constexpr void push_back(U&& u) { buf_.emplace_back(static_cast<U&&>(u)); }
+    constexpr void pop_front(std::size_t n) {
+        head_ += n;
+        if (head_ >= size()) {
+            buf_.erase(buf_.begin(), buf_.begin() + static_cast<std::ptrdiff_t>(head_));
+            head_ = 0;
+        }
+    }
+    constexpr void clear() noexcept {
+        buf_.clear();
+        head_ = 0;
+    }
+};
+
+// Stats is a split_stats_policy that is told about the comparisons and
+// searches the view makes; by default, no_split_stats, nothing is recorded.
+template<std::ranges::input_range V, std::ranges::forward_range Pattern,
+         split_stats_policy Stats = no_split_stats>
 requires std::ranges::view<V> && std::ranges::view<Pattern> &&
          std::indirectly_comparable<std::ranges::iterator_t<V>, std::ranges::iterator_t<Pattern>,
              std::ranges::equal_to> &&
-         (std::ranges::forward_range<V> || (std::ranges::sized_range<V> &&
-             (is_constexpr)([]{ Pattern::size(); }) && Pattern::size() <= 1))
-class split_view : public std::ranges::view_interface<split_view<V, Pattern>> {
+         (std::ranges::forward_range<V> || single_element_pattern<Pattern> ||
+             std::copyable<std::ranges::range_value_t<V>>)
+class split_view : public std::ranges::view_interface<split_view<V, Pattern, Stats>> {
 private:
     [[no_unique_address]] V base_ = V();
     [[no_unique_address]] Pattern pattern_ = Pattern();
+    [[no_unique_address]] Stats stats_ = Stats();
     [[no_unique_address]]
     std::conditional_t<!std::ranges::forward_range<V>,
-        std::ranges::iterator_t<V>, std::ranges::dangling> current_ = decltype(current_)();
+        std::optional<std::ranges::iterator_t<V>>, std::ranges::dangling> current_ =
+            decltype(current_)();
+    // The searcher is only stored if the iterators search with it.
+    static constexpr bool searched_ =
+        two_way_splittable<V, Pattern> || two_way_splittable<const V, Pattern>;
+    [[no_unique_address]]
+    typename std::conditional_t<searched_,
+        pattern_searcher<Pattern>,
+        std::type_identity<std::ranges::dangling>>::type searcher_ = decltype(searcher_)();
+
+    // A multi-element pattern over an input range is searched for in a
+    // lookahead buffer: the position of the iterators is the front of
+    // lookahead_, followed by the elements from current_ on.
+    static constexpr bool buffered_ =
+        !std::ranges::forward_range<V> && !single_element_pattern<Pattern>;
+    [[no_unique_address]]
+    std::conditional_t<buffered_, split_lookahead<std::ranges::range_value_t<V>>,
+        std::ranges::dangling> lookahead_ = decltype(lookahead_)();
+
+    // Reads from current_ until lookahead_ holds n elements or the base is
+    // exhausted; returns whether it holds n elements.
+    constexpr bool fill_(std::size_t n) requires buffered_ {
+        const auto end = std::ranges::end(base_);
+        for (auto& cur = *current_; lookahead_.size() < n && cur != end; ++cur)
+            lookahead_.push_back(*cur);
+        return lookahead_.size() >= n;
+    }
+    constexpr bool at_end_() requires buffered_ { return !fill_(1); }
+    constexpr bool at_pattern_() requires buffered_ {
+        const auto m = static_cast<std::size_t>(std::ranges::distance(pattern_));
+        if (!fill_(m))
+            return false;
+        auto p = std::ranges::begin(pattern_);
+        for (std::size_t i = 0; i != m; ++i, ++p) {
+            stats_.compared(1);
+            if (!std::ranges::equal_to{}(lookahead_[i], *p)) {
+                if (i != 0)
+                    stats_.false_start();
+                return false;
+            }
+        }
+        return true;
+    }
 
     template<bool> struct outer_iterator;
     template<bool> struct inner_iterator;
 
-    friend constexpr bool operator==(const inner_iterator<true>& x, std::default_sentinel_t);
-    friend constexpr bool operator==(const inner_iterator<false>& x, std::default_sentinel_t);
-
     template<bool Const> struct outer_iterator {
     private:
         template<bool> friend struct outer_iterator;
         template<bool> friend struct inner_iterator;
-        friend constexpr bool operator==(const inner_iterator<Const>& x, std::default_sentinel_t);
 
         using Parent = maybe_const<Const, split_view>;
         using Base = maybe_const<Const, V>;
@@ -53,13 +155,13 @@ private:
             if constexpr (std::ranges::forward_range<V>)
                 return this->current_;
             else
-                return parent_->current_;
+                return *parent_->current_;
         }
         constexpr auto& get_current_() const {
             if constexpr (std::ranges::forward_range<V>)
                 return this->current_;
             else
-                return parent_->current_;
+                return *parent_->current_;
         }
     public:
         using iterator_concept =
@@ -100,25 +202,71 @@ private:
         constexpr value_type operator*() const { return value_type{*this}; }
 
         constexpr outer_iterator& operator++() {
+            if constexpr (buffered_) {
+                auto& parent = *parent_;
+                parent.stats_.segment();
+                if (parent.at_end_())
+                    return *this;
+                if (std::ranges::empty(parent.pattern_)) {
+                    parent.lookahead_.pop_front(1);
+                    parent.stats_.advanced(1);
+                    return *this;
+                }
+                while (!parent.at_pattern_()) {
+                    parent.lookahead_.pop_front(1);
+                    parent.stats_.advanced(1);
+                    if (parent.at_end_())
+                        return *this;
+                }
+                const auto m = static_cast<std::size_t>(std::ranges::distance(parent.pattern_));
+                parent.lookahead_.pop_front(m);
+                parent.stats_.advanced(m);
+                return *this;
+            }
+            // Incrementing moves past a segment even when the segment's
+            // inner iterator has already consumed it up to the end.
+            const auto& stats = parent_->stats_;
+            stats.segment();
             const auto end = std::ranges::end(parent_->base_);
             if (get_current_() == end)
                 return *this;
             const auto [pbegin, pend] = std::ranges::subrange{parent_->pattern_};
-            if (pbegin == pend)
+            if (pbegin == pend) {
                 ++get_current_();
-            else if constexpr (!std::ranges::forward_range<Base>) {
-                get_current_() = std::ranges::find(std::move(get_current_()), end, *pbegin);
-                if (get_current_() != end) {
-                    ++get_current_();
+                stats.advanced(1);
+            } else if constexpr (!std::ranges::forward_range<Base>) {
+                auto& cur = get_current_();
+                while (cur != end) {
+                    const bool found = *cur == *pbegin;
+                    ++cur;
+                    stats.compared(1);
+                    stats.advanced(1);
+                    if (found)
+                        break;
                 }
+            } else if constexpr (two_way_splittable<Base, Pattern>) {
+                auto next = parent_->searcher_(get_current_(), end, parent_->pattern_).end();
+                stats.searched();
+                stats.advanced(static_cast<std::size_t>(next - get_current_()));
+                get_current_() = std::move(next);
             } else {
                 do {
                     auto [b, p] =
-                        std::ranges::mismatch(std::move(get_current_()), end, pbegin, pend);
+                        std::ranges::mismatch(get_current_(), end, pbegin, pend);
+                    if constexpr (split_stats_enabled<Stats>) {
+                        stats.compared(static_cast<std::size_t>(std::ranges::distance(pbegin, p)) +
+                            (p != pend && b != end));
+                        if (p != pbegin && p != pend)
+                            stats.false_start();
+                    }
                     if (p == pend) {
+                        if constexpr (split_stats_enabled<Stats>)
+                            stats.advanced(
+                                static_cast<std::size_t>(std::ranges::distance(pbegin, pend)));
                         get_current_() = std::move(b);
                         break;
                     }
+                    stats.advanced(1);
                 } while (++get_current_() != end);
             }
             return *this;
@@ -139,39 +287,81 @@ private:
             return x.current_ == y.current_;
         }
         friend constexpr bool operator==(const outer_iterator& x, std::default_sentinel_t) {
-            return x.get_current_() == std::ranges::end(x.parent_->base_);
+            return x.at_end_();
+        }
+    private:
+        // The comparisons with default_sentinel_t are implemented as members,
+        // which, unlike friends of a nested class, have access to the
+        // private members of split_view.
+        constexpr bool at_end_() const {
+            if constexpr (buffered_)
+                return parent_->at_end_();
+            else
+                return get_current_() == std::ranges::end(parent_->base_);
         }
     };
 
     template<bool Const>
-    struct inner_iterator {
+    struct inner_iterator : split_inner_iterator_category<maybe_const<Const, V>> {
     private:
         using Base = maybe_const<Const, V>;
         outer_iterator<Const> i_ = decltype(i_)();
         bool incremented_ = false;
+        // The start of the next occurrence of the pattern, found once when
+        // the iterator is created from its outer_iterator.
+        [[no_unique_address]]
+        std::conditional_t<two_way_splittable<Base, Pattern>,
+            std::ranges::iterator_t<Base>, std::ranges::dangling> match_ = decltype(match_)();
     public:
         using iterator_concept = typename outer_iterator<Const>::iterator_concept;
-        using iterator_category = std::conditional_t<
-            std::derived_from<
-                typename std::iterator_traits<std::ranges::iterator_t<Base>>::iterator_category,
-                std::forward_iterator_tag>,
-            std::forward_iterator_tag,
-            typename std::iterator_traits<std::ranges::iterator_t<Base>>::iterator_category>;
         using value_type = std::ranges::range_value_t<Base>;
         using difference_type = std::ranges::range_difference_t<Base>;
 
         inner_iterator() = default;
-        constexpr explicit inner_iterator(outer_iterator<Const> i) : i_(std::move(i)) {}
+        constexpr explicit inner_iterator(outer_iterator<Const> i) : i_(std::move(i)) {
+            if constexpr (two_way_splittable<Base, Pattern>) {
+                if (!std::ranges::empty(i_.parent_->pattern_)) {
+                    match_ = i_.parent_->searcher_(i_.current_,
+                        std::ranges::end(i_.parent_->base_), i_.parent_->pattern_).begin();
+                    i_.parent_->stats_.searched();
+                }
+            }
+        }
 
-        constexpr decltype(auto) operator*() const { return *i_.get_current_(); }
+        constexpr const std::ranges::iterator_t<Base>& base() const& noexcept
+            requires std::ranges::forward_range<V> {
+            return i_.current_;
+        }
+        constexpr std::ranges::iterator_t<Base> base() &&
+            requires std::ranges::forward_range<V> {
+            return std::move(i_.current_);
+        }
+
+        constexpr decltype(auto) operator*() const {
+            if constexpr (buffered_) {
+                i_.parent_->fill_(1);
+                return i_.parent_->lookahead_[0];
+            } else
+                return *i_.get_current_();
+        }
         constexpr inner_iterator& operator++() {
             incremented_ = true;
-            if constexpr (!std::ranges::forward_range<Base>) {
+            if constexpr (buffered_) {
+                // With an empty pattern, each segment is one element, and
+                // the outer_iterator consumes it.
+                if (!std::ranges::empty(i_.parent_->pattern_)) {
+                    i_.parent_->fill_(1);
+                    i_.parent_->lookahead_.pop_front(1);
+                    i_.parent_->stats_.advanced(1);
+                }
+                return *this;
+            } else if constexpr (!std::ranges::forward_range<Base>) {
                 if constexpr (Pattern::size() == 0) {
                     return *this;
                 }
             }
             ++i_.get_current_();
+            i_.parent_->stats_.advanced(1);
             return *this;
         }
         constexpr decltype(auto) operator++(int) {
@@ -189,49 +379,78 @@ private:
             return x.i_.get_current_() == y.i_.get_current_();
         }
         friend constexpr bool operator==(const inner_iterator& x, std::default_sentinel_t) {
-            auto [pcur, pend] = std::ranges::subrange{x.i_.parent_->pattern_};
-            auto end = std::ranges::end(x.i_.parent_->base_);
-            if constexpr (!std::ranges::forward_range<Base>) {
-                const auto& cur = x.i_.get_current_();
-                if (cur == end) return true;
-                if (pcur == pend) return x.incremented_;
-                return *cur == *pcur;
-            } else {
-                auto cur = x.i_.get_current_();
-                if (cur == end) return true;
-                if (pcur == pend) return x.incremented_;
-                do {
-                    if (*cur != *pcur) return false;
-                    if (++pcur == pend) return true;
-                } while (++cur != end);
-                return false;
-            }
+            return x.at_end_();
         }
 
         friend constexpr decltype(auto) iter_move(const inner_iterator& i)
-            noexcept(noexcept(std::ranges::iter_move(i.i_.get_current_()))) {
+            noexcept(noexcept(std::ranges::iter_move(i.i_.get_current_())))
+            requires (!buffered_) {
             return std::ranges::iter_move(i.i_.get_current_());
         }
 
         friend constexpr void iter_swap(const inner_iterator& x, const inner_iterator& y)
             noexcept(noexcept(std::ranges::iter_swap(x.i_.get_current_(), y.i_.get_current_())))
-            requires std::indirectly_swappable<std::ranges::iterator_t<Base>> {
+            requires (!buffered_) && std::indirectly_swappable<std::ranges::iterator_t<Base>> {
             std::ranges::iter_swap(x.i_.get_current_(), y.i_.get_current_());
         }
+    private:
+        constexpr bool at_end_() const {
+            auto [pcur, pend] = std::ranges::subrange{i_.parent_->pattern_};
+            auto end = std::ranges::end(i_.parent_->base_);
+            const auto& stats = i_.parent_->stats_;
+            if constexpr (buffered_) {
+                if (i_.parent_->at_end_()) return true;
+                if (pcur == pend) return incremented_;
+                return i_.parent_->at_pattern_();
+            } else if constexpr (!std::ranges::forward_range<Base>) {
+                const auto& cur = i_.get_current_();
+                if (cur == end) return true;
+                if (pcur == pend) return incremented_;
+                stats.compared(1);
+                return *cur == *pcur;
+            } else {
+                auto cur = i_.get_current_();
+                if (cur == end) return true;
+                if (pcur == pend) return incremented_;
+                if constexpr (two_way_splittable<Base, Pattern>)
+                    return cur == match_;
+                const auto pbegin = pcur;
+                do {
+                    stats.compared(1);
+                    if (*cur != *pcur) {
+                        if (pcur != pbegin)
+                            stats.false_start();
+                        return false;
+                    }
+                    if (++pcur == pend) return true;
+                } while (++cur != end);
+                stats.false_start();
+                return false;
+            }
+        }
     };
 
+    constexpr void init_searcher_() {
+        if constexpr (searched_)
+            searcher_ = decltype(searcher_)(std::as_const(pattern_));
+    }
+
 public:
     split_view() = default;
-    constexpr split_view(V base, Pattern pattern)
-        : base_(std::move(base)), pattern_(std::move(pattern)) {}
+    constexpr split_view(V base, Pattern pattern, Stats stats = Stats())
+        : base_(std::move(base)), pattern_(std::move(pattern)), stats_(std::move(stats)) {
+        init_searcher_();
+    }
 
     template<std::ranges::input_range R>
     requires std::constructible_from<V, std::views::all_t<R>> &&
              std::constructible_from<Pattern,
                  std::ranges::single_view<std::ranges::range_value_t<R>>>
-    constexpr split_view(R&& r, std::ranges::range_value_t<R> e)
+    constexpr split_view(R&& r, std::ranges::range_value_t<R> e, Stats stats = Stats())
         : base_(std::views::all(std::forward<R>(r))),
-          pattern_(std::ranges::single_view{std::move(e)}) {}
+          pattern_(std::ranges::single_view{std::move(e)}), stats_(std::move(stats)) {
+        init_searcher_();
+    }
 
     constexpr V base() const& requires std::copy_constructible<V> { return base_; }
     constexpr V base() && { return std::move(base_); }
@@ -240,7 +459,9 @@ public:
         if constexpr (std::ranges::forward_range<V>)
             return outer_iterator<simple_view<V>>{*this, std::ranges::begin(base_)};
         else {
-            current_ = std::ranges::begin(base_);
+            current_.emplace(std::ranges::begin(base_));
+            if constexpr (buffered_)
+                lookahead_.clear();
             return outer_iterator<false>{*this};
         }
     }
@@ -271,3 +492,10 @@ template<std::ranges::input_range R>
 split_view(R&&, std::ranges::range_value_t<R>)
     -> split_view<std::views::all_t<R>, std::ranges::single_view<std::ranges::range_value_t<R>>>;
 
+template<class R, class P, split_stats_policy Stats>
+split_view(R&&, P&&, Stats) -> split_view<std::views::all_t<R>, std::views::all_t<P>, Stats>;
+
+template<std::ranges::input_range R, split_stats_policy Stats>
+split_view(R&&, std::ranges::range_value_t<R>, Stats)
+    -> split_view<std::views::all_t<R>, std::ranges::single_view<std::ranges::range_value_t<R>>,
+                  Stats>;
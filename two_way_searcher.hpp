@@ -0,0 +1,324 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class T>
+    class two_way_searcher {
+    public:
+        constexpr two_way_searcher() noexcept;
+        template<std::ranges::random_access_range P>
+        constexpr explicit two_way_searcher(const P& pattern);
+
+        template<std::random_access_iterator I, std::sized_sentinel_for<I> S,
+            std::ranges::random_access_range P>
+        constexpr std::ranges::subrange<I> operator()(I first, S last,
+            const P& pattern) const;
+    };
+
+    template<class T>
+    struct element_searcher {
+        constexpr element_searcher() noexcept = default;
+        template<std::ranges::random_access_range P>
+        constexpr explicit element_searcher(const P& pattern) noexcept;
+
+        template<std::random_access_iterator I, std::sized_sentinel_for<I> S,
+            std::ranges::random_access_range P>
+        constexpr std::ranges::subrange<I> operator()(I first, S last,
+            const P& pattern) const;
+    };
+
+    template<class Pattern>
+    concept single_element_pattern;
+
+    template<class Pattern>
+    struct pattern_searcher;
+*/
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#include "simd_find.hpp"
+
+// The bad-character table used by two_way_searcher for one-byte element
+// types. Shifts are capped at 255, which only makes them more conservative.
+struct two_way_shift_table {
+    std::array<unsigned char, 256> shift{};
+};
+struct two_way_no_shift_table {};
+
+template<class I>
+inline constexpr bool two_way_reverse_contiguous = false;
+template<std::contiguous_iterator I>
+inline constexpr bool two_way_reverse_contiguous<std::reverse_iterator<I>> = true;
+
+// A two_way_searcher finds occurrences of a pattern with the Two-Way
+// algorithm of Crochemore and Perrin, which runs in linear time and constant
+// extra space. It requires the element type to be totally ordered.
+// For one-byte element types it is combined with a Horspool bad-character
+// table on the last element of the window, which lets it skip up to
+// min(pattern size, 255) elements at a time on mismatching text.
+// All state is computed from the pattern once, at construction; the pattern
+// itself is not stored and must be passed again to each search, so that the
+// searcher stays valid when the pattern's owner is copied or moved.
+// A size-1 pattern over contiguous simd_findable text is searched for with
+// simd_find instead, and over reversed contiguous text (reverse_iterators,
+// e.g. to find the last occurrence) with simd_rfind.
+template<class T>
+class two_way_searcher {
+    static constexpr bool has_table = simd_findable<T> && sizeof(T) == 1;
+
+    std::ptrdiff_t suffix_ = 0;
+    std::ptrdiff_t period_ = 1;
+    bool periodic_ = false;
+    [[no_unique_address]]
+    std::conditional_t<has_table, two_way_shift_table, two_way_no_shift_table> table_{};
+
+    template<class I>
+    static constexpr bool uses_table =
+        has_table && std::same_as<std::iter_value_t<I>, T>;
+
+    static constexpr unsigned char byte(T t) noexcept {
+        return static_cast<unsigned char>(t);
+    }
+
+    template<class I, class PI>
+    static constexpr bool eq(const I& text, std::ptrdiff_t k, const PI& pat,
+        std::ptrdiff_t i)
+    {
+        return std::ranges::equal_to{}(text[k], pat[i]);
+    }
+
+    // Computes the maximal suffix of the pattern for the given order; returns
+    // its position minus one and stores the period of that suffix in period.
+    template<class PI, class Comp>
+    static constexpr std::ptrdiff_t max_suffix(PI p, std::ptrdiff_t m,
+        std::ptrdiff_t& period, Comp comp)
+    {
+        std::ptrdiff_t ms = -1, j = 0, k = 1;
+        period = 1;
+        while (j + k < m) {
+            const auto& a = p[j + k];
+            const auto& b = p[ms + k];
+            if (comp(a, b)) {
+                j += k;
+                k = 1;
+                period = j - ms;
+            } else if (a == b) {
+                if (k != period)
+                    ++k;
+                else {
+                    j += period;
+                    k = 1;
+                }
+            } else {
+                ms = j++;
+                k = period = 1;
+            }
+        }
+        return ms;
+    }
+public:
+    constexpr two_way_searcher() noexcept = default;
+
+    template<std::ranges::random_access_range P>
+    constexpr explicit two_way_searcher(const P& pattern) {
+        const auto p = std::ranges::begin(pattern);
+        const auto m = static_cast<std::ptrdiff_t>(std::ranges::distance(pattern));
+        if (m == 0)
+            return;
+
+        std::ptrdiff_t p1, p2;
+        const auto s1 = (max_suffix)(p, m, p1, std::ranges::less{});
+        const auto s2 = (max_suffix)(p, m, p2, std::ranges::greater{});
+        if (s1 >= s2) {
+            suffix_ = s1 + 1;
+            period_ = p1;
+        } else {
+            suffix_ = s2 + 1;
+            period_ = p2;
+        }
+
+        periodic_ = suffix_ + period_ <= m;
+        for (std::ptrdiff_t i = 0; periodic_ && i < suffix_; ++i)
+            periodic_ = p[i] == p[i + period_];
+        if (!periodic_)
+            period_ = std::max(suffix_, m - suffix_) + 1;
+
+        if constexpr (has_table) {
+            table_.shift.fill(static_cast<unsigned char>(std::min<std::ptrdiff_t>(m, 255)));
+            for (std::ptrdiff_t i = 0; i < m; ++i)
+                table_.shift[(byte)(p[i])] =
+                    static_cast<unsigned char>(std::min<std::ptrdiff_t>(m - i - 1, 255));
+        }
+    }
+
+    // Returns the first occurrence of pattern in [first, last), or an empty
+    // range at last if there is none. pattern must be equal to the pattern
+    // the searcher was constructed from.
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S,
+        std::ranges::random_access_range P>
+    constexpr std::ranges::subrange<I> operator()(I first, S last,
+        const P& pattern) const
+    {
+        const auto p = std::ranges::begin(pattern);
+        const auto m = static_cast<std::ptrdiff_t>(std::ranges::distance(pattern));
+        const auto n = static_cast<std::ptrdiff_t>(last - first);
+        const auto found = [&](std::ptrdiff_t j) -> std::ranges::subrange<I> {
+            return { first + j, first + (j + m) };
+        };
+        const auto not_found = [&]() -> std::ranges::subrange<I> {
+            return { first + n, first + n };
+        };
+        if (m == 0)
+            return found(0);
+
+        if constexpr (std::contiguous_iterator<I> && simd_findable<std::iter_value_t<I>> &&
+            std::same_as<std::iter_value_t<I>, T>)
+        {
+            if (!std::is_constant_evaluated() && m == 1) {
+                const auto b = std::to_address(first);
+                const auto pos = (simd_find)(b, b + n, static_cast<T>(p[0]));
+                return pos == b + n ? not_found() : found(pos - b);
+            }
+        } else if constexpr (two_way_reverse_contiguous<I> &&
+            simd_findable<std::iter_value_t<I>> && std::same_as<std::iter_value_t<I>, T>)
+        {
+            if (!std::is_constant_evaluated() && m == 1) {
+                const auto e = std::to_address(first.base());
+                const auto pos = (simd_rfind)(e - n, e, static_cast<T>(p[0]));
+                return pos == e ? not_found() : found(e - 1 - pos);
+            }
+        }
+
+        // Compare the right half of the factorization left to right, then
+        // the left half right to left. With the table, the last element of
+        // the window has already been matched by the time either half is
+        // compared.
+        const std::ptrdiff_t right_end = uses_table<I> ? m - 1 : m;
+        std::ptrdiff_t j = 0;
+        if (periodic_) {
+            std::ptrdiff_t memory = 0;
+            while (j <= n - m) {
+                if constexpr (uses_table<I>) {
+                    if (const auto shift = table_.shift[(byte)(first[j + m - 1])]) {
+                        memory = 0;
+                        j += shift;
+                        continue;
+                    }
+                }
+                auto i = std::max(suffix_, memory);
+                while (i < right_end && (eq)(first, i + j, p, i))
+                    ++i;
+                if (i >= right_end) {
+                    i = suffix_ - 1;
+                    while (memory <= i && (eq)(first, i + j, p, i))
+                        --i;
+                    if (i < memory)
+                        return found(j);
+                    memory = m - period_;
+                    j += period_;
+                } else {
+                    j += i - suffix_ + 1;
+                    memory = 0;
+                }
+            }
+        } else {
+            while (j <= n - m) {
+                if constexpr (uses_table<I>) {
+                    if (const auto shift = table_.shift[(byte)(first[j + m - 1])]) {
+                        j += shift;
+                        continue;
+                    }
+                }
+                auto i = suffix_;
+                while (i < right_end && (eq)(first, i + j, p, i))
+                    ++i;
+                if (i >= right_end) {
+                    i = suffix_ - 1;
+                    while (i >= 0 && (eq)(first, i + j, p, i))
+                        --i;
+                    if (i < 0)
+                        return found(j);
+                    j += period_;
+                } else
+                    j += i - suffix_ + 1;
+            }
+        }
+        return not_found();
+    }
+};
+
+// An element_searcher finds occurrences of a pattern of at most one
+// element, like two_way_searcher but with no state: over contiguous
+// simd_findable text with simd_find, over reversed contiguous text with
+// simd_rfind, and otherwise element by element.
+template<class T>
+struct element_searcher {
+    constexpr element_searcher() noexcept = default;
+
+    template<std::ranges::random_access_range P>
+    constexpr explicit element_searcher(const P&) noexcept {}
+
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S,
+        std::ranges::random_access_range P>
+    constexpr std::ranges::subrange<I> operator()(I first, S last,
+        const P& pattern) const
+    {
+        const auto n = static_cast<std::ptrdiff_t>(last - first);
+        const auto found = [&](std::ptrdiff_t j) -> std::ranges::subrange<I> {
+            return { first + j, first + (j + 1) };
+        };
+        const auto not_found = [&]() -> std::ranges::subrange<I> {
+            return { first + n, first + n };
+        };
+        if (std::ranges::empty(pattern))
+            return { first, first };
+        const auto& x = *std::ranges::begin(pattern);
+
+        if constexpr (std::contiguous_iterator<I> && simd_findable<std::iter_value_t<I>> &&
+            std::same_as<std::iter_value_t<I>, T>)
+        {
+            if (!std::is_constant_evaluated()) {
+                const auto b = std::to_address(first);
+                const auto pos = (simd_find)(b, b + n, static_cast<T>(x));
+                return pos == b + n ? not_found() : found(pos - b);
+            }
+        } else if constexpr (two_way_reverse_contiguous<I> &&
+            simd_findable<std::iter_value_t<I>> && std::same_as<std::iter_value_t<I>, T>)
+        {
+            if (!std::is_constant_evaluated()) {
+                const auto e = std::to_address(first.base());
+                const auto pos = (simd_rfind)(e - n, e, static_cast<T>(x));
+                return pos == e ? not_found() : found(e - 1 - pos);
+            }
+        }
+
+        const auto it = std::ranges::find(first, first + n, x);
+        return it == first + n ? not_found() : found(it - first);
+    }
+};
+
+// Whether the size of Pattern is a constant expression not greater than 1,
+// e.g. a std::ranges::single_view, which an element_searcher can search for
+// and which lets split_view search an input range without looking ahead.
+template<class Pattern>
+concept single_element_pattern = std::ranges::sized_range<Pattern> &&
+    requires { typename std::integral_constant<std::size_t, Pattern::size()>; } &&
+    (Pattern::size() <= 1);
+
+// The searcher the split views construct from a Pattern: an
+// element_searcher for a single_element_pattern, and a two_way_searcher
+// otherwise. Pattern types that know better, such as fixed_pattern,
+// specialize it; the searcher must be constructible from a const Pattern&
+// and callable like two_way_searcher.
+template<class Pattern>
+struct pattern_searcher {
+    using type = std::conditional_t<single_element_pattern<Pattern>,
+        element_searcher<std::ranges::range_value_t<Pattern>>,
+        two_way_searcher<std::ranges::range_value_t<Pattern>>>;
+};
@@ -0,0 +1,240 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<std::ranges::contiguous_range V>
+    class utf8_split_view {
+    public:
+        using char_type = std::ranges::range_value_t<const V>;
+        using segment_type = typename contiguous_segment<V>::type;
+
+        utf8_split_view() = default;
+        constexpr utf8_split_view(V base, std::basic_string_view<char_type> delimiter);
+        constexpr utf8_split_view(V base, char32_t delimiter);
+
+        constexpr V base() const&;
+        constexpr V base() &&;
+        constexpr std::basic_string_view<char_type> delimiter() const noexcept;
+
+        iterator begin() const;
+        std::default_sentinel_t end() const noexcept;
+    };
+*/
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "contiguous_split_view.hpp"
+#include "simd_find.hpp"
+#include "utf8_validate.hpp"
+
+// A utf8_split_view splits UTF-8 text on a delimiter of one or more code
+// points, given as UTF-8 or as a single char32_t, and validates the text in
+// the same pass: each 64-code-unit block is read once, by utf8_scan_block,
+// which both checks it and finds the candidate positions of the delimiter
+// (the text after the last full block is checked and searched by scalar
+// loops). Since the delimiter is itself valid UTF-8, a match in valid text
+// always starts and ends on code point boundaries, so no segment boundary
+// falls inside a code point.
+// The segments are those of the corresponding split_view: a trailing
+// delimiter does not start a final empty segment, and an empty delimiter
+// splits the text into single code points. An invalid delimiter throws
+// std::invalid_argument from the constructor; invalid text throws
+// utf8_error, with the offset of the first invalid sequence, from the
+// iterator operation that reaches it, so every segment yielded before it is
+// valid.
+// The iterator is a forward iterator whose reference type is segment_type.
+template<std::ranges::contiguous_range V>
+requires std::ranges::view<V> && std::ranges::contiguous_range<const V> &&
+         std::ranges::sized_range<const V> &&
+         utf8_code_unit<std::ranges::range_value_t<const V>>
+class utf8_split_view : public std::ranges::view_interface<utf8_split_view<V>> {
+public:
+    using char_type = std::ranges::range_value_t<const V>;
+    using segment_type = typename contiguous_segment<V>::type;
+private:
+    [[no_unique_address]] V base_ = V();
+    std::basic_string<char_type> delimiter_;
+
+    static constexpr std::ptrdiff_t block_size = 64;
+
+    static std::basic_string<char_type> checked_(std::basic_string_view<char_type> delimiter) {
+        const auto first = delimiter.data();
+        const auto last = first + delimiter.size();
+        if ((utf8_find_invalid)(first, last) != last)
+            throw std::invalid_argument("utf8_split_view: delimiter is not valid UTF-8");
+        return std::basic_string<char_type>(delimiter);
+    }
+
+    static std::basic_string<char_type> encoded_(char32_t c) {
+        if (c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+            throw std::invalid_argument("utf8_split_view: delimiter is not a code point");
+        const auto unit = [](std::uint32_t u) { return static_cast<char_type>(u); };
+        std::basic_string<char_type> s;
+        if (c < 0x80)
+            s = { unit(c) };
+        else if (c < 0x800)
+            s = { unit(0xc0 | c >> 6), unit(0x80 | (c & 0x3f)) };
+        else if (c < 0x10000)
+            s = { unit(0xe0 | c >> 12), unit(0x80 | (c >> 6 & 0x3f)), unit(0x80 | (c & 0x3f)) };
+        else
+            s = { unit(0xf0 | c >> 18), unit(0x80 | (c >> 12 & 0x3f)),
+                  unit(0x80 | (c >> 6 & 0x3f)), unit(0x80 | (c & 0x3f)) };
+        return s;
+    }
+
+    struct iterator {
+    private:
+        friend utf8_split_view;
+
+        const utf8_split_view* parent_ = nullptr;
+        const char_type* cur_ = nullptr;
+        const char_type* seg_end_ = nullptr;
+        const char_type* next_ = nullptr;
+        // The text before block_ has been checked; the candidates of the
+        // block before it that are not yet consumed are the bits of cands_.
+        // Once the rest of the text is checked too, tail_ is set and block_
+        // is where that rest starts.
+        const char_type* block_ = nullptr;
+        std::uint64_t cands_ = 0;
+        bool tail_ = false;
+
+        iterator(const utf8_split_view& parent, const char_type* first)
+            : parent_(std::addressof(parent)), cur_(first), seg_end_(first), next_(first),
+              block_(first) {}
+
+        const char_type* first_() const noexcept { return std::ranges::data(parent_->base_); }
+        const char_type* last_() const noexcept {
+            return first_() + std::ranges::size(parent_->base_);
+        }
+
+        [[noreturn]] void fail_(const char_type* from) const {
+            const auto first = first_();
+            const auto start = (utf8_sequence_start)(first, from);
+            throw utf8_error(static_cast<std::size_t>(
+                (utf8_find_invalid)(start, last_()) - first));
+        }
+
+        bool matches_(const char_type* p) const noexcept {
+            const auto& d = parent_->delimiter_;
+            return std::equal(d.begin(), d.end(), p);
+        }
+
+        // Finds the end of the segment starting at cur_ and the start of the
+        // following one, checking the text up to the end of the match.
+        void find_() {
+            const auto first = first_();
+            const auto last = last_();
+            if (cur_ == last)
+                return;
+            const auto& d = parent_->delimiter_;
+            const auto m = static_cast<std::ptrdiff_t>(d.size());
+            if (m == 0) {
+                const auto e = (utf8_find_invalid)(cur_, cur_ + 1, last);
+                if (e == cur_)
+                    fail_(cur_);
+                seg_end_ = next_ = e;
+                return;
+            }
+            for (;;) {
+                for (; cands_; cands_ &= cands_ - 1) {
+                    const auto p = block_ - block_size + std::countr_zero(cands_);
+                    if (p >= cur_ && matches_(p)) {
+                        cands_ &= cands_ - 1;
+                        seg_end_ = p;
+                        next_ = p + m;
+                        return;
+                    }
+                }
+                if (tail_)
+                    break;
+                if (last - block_ >= block_size + m - 1) {
+                    const auto r = (utf8_scan_block)(first, block_, d.data(),
+                        static_cast<std::size_t>(m), last);
+                    if (!r.valid)
+                        fail_(block_);
+                    cands_ = r.candidates;
+                    block_ += block_size;
+                } else {
+                    if ((utf8_find_invalid)((utf8_sequence_start)(first, block_), last) != last)
+                        fail_(block_);
+                    tail_ = true;
+                }
+            }
+            auto p = std::max(cur_, block_);
+            for (; last - p >= m; ++p) {
+                if (*p == d[0] && matches_(p)) {
+                    seg_end_ = p;
+                    next_ = p + m;
+                    return;
+                }
+            }
+            seg_end_ = next_ = last;
+        }
+
+        bool at_end_() const noexcept { return cur_ == last_(); }
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = segment_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        segment_type operator*() const {
+            return segment_type(cur_, static_cast<std::size_t>(seg_end_ - cur_));
+        }
+
+        iterator& operator++() {
+            cur_ = next_;
+            find_();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& x, const iterator& y) {
+            return x.cur_ == y.cur_;
+        }
+        friend bool operator==(const iterator& x, std::default_sentinel_t) {
+            return x.at_end_();
+        }
+    };
+
+public:
+    utf8_split_view() = default;
+    constexpr utf8_split_view(V base, std::basic_string_view<char_type> delimiter)
+        : base_(std::move(base)), delimiter_((checked_)(delimiter)) {}
+    constexpr utf8_split_view(V base, char32_t delimiter)
+        : base_(std::move(base)), delimiter_((encoded_)(delimiter)) {}
+
+    constexpr V base() const& requires std::copy_constructible<V> { return base_; }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr std::basic_string_view<char_type> delimiter() const noexcept { return delimiter_; }
+
+    // Finds the end of the first segment, so it is not O(1), and throws
+    // utf8_error if the text up to it is not valid.
+    iterator begin() const {
+        iterator it{*this, std::ranges::data(base_)};
+        it.find_();
+        return it;
+    }
+    std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+};
+
+template<class R, class D>
+utf8_split_view(R&&, D&&) -> utf8_split_view<std::views::all_t<R>>;
@@ -0,0 +1,327 @@
+#pragma once
+
+/*
+    synopsis
+
+    class utf8_error : public std::runtime_error {
+    public:
+        explicit utf8_error(std::size_t offset);
+        std::size_t offset() const noexcept;
+    };
+
+    template<class T>
+    concept utf8_code_unit;
+
+    template<utf8_code_unit T>
+    constexpr const T* utf8_find_invalid(const T* first, const T* last) noexcept;
+    template<utf8_code_unit T>
+    constexpr const T* utf8_find_invalid(const T* first, const T* stop, const T* last) noexcept;
+
+    template<utf8_code_unit T>
+    constexpr const T* utf8_sequence_start(const T* first, const T* p) noexcept;
+
+    struct utf8_block {
+        std::uint64_t candidates;
+        bool valid;
+    };
+
+    template<utf8_code_unit T>
+    utf8_block utf8_scan_block(const T* first, const T* p,
+        const T* pattern, std::size_t m, const T* last) noexcept;
+*/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "simd_find.hpp"
+
+// Thrown when invalid UTF-8 is found; offset() is the position of the first
+// code unit of the invalid sequence.
+class utf8_error : public std::runtime_error {
+    std::size_t offset_;
+public:
+    explicit utf8_error(std::size_t offset)
+        : std::runtime_error("invalid UTF-8 at offset " + std::to_string(offset)),
+          offset_(offset) {}
+
+    std::size_t offset() const noexcept { return offset_; }
+};
+
+// The types UTF-8 text is made of, e.g. char and char8_t.
+template<class T>
+concept utf8_code_unit = simd_findable<T> && sizeof(T) == 1;
+
+// Validates the sequences that start in [first, stop), reading up to last,
+// and returns the first one that is invalid (a bad lead byte, a missing or
+// extra continuation byte, an overlong encoding, a surrogate or a value
+// above U+10FFFF, or a sequence cut off by last), or the end of the last
+// sequence if all are valid, which is not before stop.
+template<utf8_code_unit T>
+constexpr const T* utf8_find_invalid(const T* first, const T* stop, const T* last) noexcept {
+    while (first < stop) {
+        const auto c = static_cast<unsigned char>(first[0]);
+        if (c < 0x80) {
+            ++first;
+            continue;
+        }
+        std::ptrdiff_t n;
+        unsigned lo = 0x80, hi = 0xbf;
+        if (c >= 0xc2 && c <= 0xdf)
+            n = 1;
+        else if (c >= 0xe0 && c <= 0xef) {
+            n = 2;
+            if (c == 0xe0)
+                lo = 0xa0;
+            else if (c == 0xed)
+                hi = 0x9f;
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            n = 3;
+            if (c == 0xf0)
+                lo = 0x90;
+            else if (c == 0xf4)
+                hi = 0x8f;
+        } else
+            return first;
+        if (last - first <= n)
+            return first;
+        const auto c1 = static_cast<unsigned char>(first[1]);
+        if (c1 < lo || c1 > hi)
+            return first;
+        for (std::ptrdiff_t k = 2; k <= n; ++k)
+            if ((static_cast<unsigned char>(first[k]) & 0xc0) != 0x80)
+                return first;
+        first += n + 1;
+    }
+    return first;
+}
+
+// Returns the first invalid sequence in [first, last), or last.
+template<utf8_code_unit T>
+constexpr const T* utf8_find_invalid(const T* first, const T* last) noexcept {
+    return (utf8_find_invalid)(first, last, last);
+}
+
+// Returns the start of the sequence that p is in, or p if it starts one,
+// assuming the text before p is valid; never goes before first.
+template<utf8_code_unit T>
+constexpr const T* utf8_sequence_start(const T* first, const T* p) noexcept {
+    std::ptrdiff_t k = 0;
+    while (k != 3 && p - k != first && (static_cast<unsigned char>(p[-k - 1]) & 0xc0) == 0x80)
+        ++k;
+    if (k == 3 || p - k == first)
+        return k == 3 ? p : p - k;
+    const auto lead = static_cast<unsigned char>(p[-k - 1]);
+    const std::ptrdiff_t length = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 1;
+    return length > k + 1 ? p - k - 1 : p;
+}
+
+// The result of scanning a 64-code-unit block: whether the block is valid
+// UTF-8, given the code units before it, and the candidate positions i of
+// the pattern, those where p[i] and p[i + m - 1] are its first and last code
+// units.
+struct utf8_block {
+    std::uint64_t candidates;
+    bool valid;
+};
+
+// The lookup tables of the validation algorithm of Keiser and Lemire
+// ("Validating UTF-8 in less than one instruction per byte", 2021). Each
+// pair of consecutive code units is classified by three 16-entry tables,
+// indexed by the high and low nibble of the first and the high nibble of
+// the second; a bit set in all three is an error, except that the
+// continuation bits are required exactly where the previous two or three
+// code units started a three- or four-byte sequence.
+struct utf8_lookup {
+    static constexpr std::uint8_t too_short = 1 << 0;
+    static constexpr std::uint8_t too_long = 1 << 1;
+    static constexpr std::uint8_t overlong_3 = 1 << 2;
+    static constexpr std::uint8_t too_large = 1 << 3;
+    static constexpr std::uint8_t surrogate = 1 << 4;
+    static constexpr std::uint8_t overlong_2 = 1 << 5;
+    static constexpr std::uint8_t too_large_1000 = 1 << 6;
+    static constexpr std::uint8_t overlong_4 = 1 << 6;
+    static constexpr std::uint8_t two_conts = 1 << 7;
+    static constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+    static constexpr std::uint8_t byte_1_high[16] = {
+        too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+        two_conts, two_conts, two_conts, two_conts,
+        too_short | overlong_2,
+        too_short,
+        too_short | overlong_3 | surrogate,
+        too_short | too_large | too_large_1000 | overlong_4,
+    };
+    static constexpr std::uint8_t byte_1_low[16] = {
+        carry | overlong_3 | overlong_2 | overlong_4,
+        carry | overlong_2,
+        carry,
+        carry,
+        carry | too_large,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+    };
+    static constexpr std::uint8_t byte_2_high[16] = {
+        too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_short, too_short, too_short, too_short,
+    };
+};
+
+// Copies the up to n code units before p, but not before first, to the end
+// of a zeroed buffer of n code units, so that the block before p can be
+// loaded at the start of the text.
+template<class T>
+inline void utf8_previous(const T* first, const T* p, unsigned char* out, std::size_t n) noexcept {
+    std::memset(out, 0, n);
+    const auto k = std::min(n, static_cast<std::size_t>(p - first));
+    std::memcpy(out + n - k, p - k, k);
+}
+
+template<utf8_code_unit T>
+utf8_block utf8_scan_block_scalar(const T* first, const T* p,
+    const T* pattern, std::size_t m, const T* last) noexcept
+{
+    utf8_block r{ 0, true };
+    if (m != 0)
+        for (std::size_t i = 0; i != 64; ++i)
+            if (p[i] == pattern[0] && p[i + m - 1] == pattern[m - 1])
+                r.candidates |= std::uint64_t(1) << i;
+    const auto start = (utf8_sequence_start)(first, p);
+    const auto e = (utf8_find_invalid)(start, p + 64, last);
+    r.valid = e >= p + 64;
+    return r;
+}
+
+#ifdef SIMD_FIND_X86
+#if defined(__GNUC__)
+template<utf8_code_unit T>
+__attribute__((target("ssse3")))
+utf8_block utf8_scan_block_ssse3(const T* first, const T* p,
+    const T* pattern, std::size_t m) noexcept
+{
+    using L = utf8_lookup;
+    const __m128i b1h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(L::byte_1_high));
+    const __m128i b1l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(L::byte_1_low));
+    const __m128i b2h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(L::byte_2_high));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    unsigned char before[16];
+    (utf8_previous)(first, p, before, sizeof before);
+    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(before));
+    __m128i error = _mm_setzero_si128();
+    utf8_block r{ 0, true };
+    const __m128i front = _mm_set1_epi8(static_cast<char>(m ? pattern[0] : T()));
+    const __m128i back = _mm_set1_epi8(static_cast<char>(m ? pattern[m - 1] : T()));
+    for (int i = 0; i != 4; ++i) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        const __m128i prev1 = _mm_alignr_epi8(x, prev, 15);
+        const __m128i special = _mm_and_si128(_mm_and_si128(
+            _mm_shuffle_epi8(b1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+            _mm_shuffle_epi8(b1l, _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(b2h, _mm_and_si128(_mm_srli_epi16(x, 4), nibble)));
+        const __m128i prev2 = _mm_alignr_epi8(x, prev, 14);
+        const __m128i prev3 = _mm_alignr_epi8(x, prev, 13);
+        const __m128i must23 = _mm_or_si128(
+            _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80))),
+            _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80))));
+        const __m128i must23_80 = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+        error = _mm_or_si128(error, _mm_xor_si128(must23_80, special));
+        prev = x;
+        if (m != 0) {
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i + m - 1));
+            const auto c = static_cast<std::uint16_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(x, front), _mm_cmpeq_epi8(y, back))));
+            r.candidates |= std::uint64_t(c) << (16 * i);
+        }
+    }
+    r.valid = _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xffff;
+    return r;
+}
+
+template<utf8_code_unit T>
+SIMD_FIND_TARGET_AVX2
+utf8_block utf8_scan_block_avx2(const T* first, const T* p,
+    const T* pattern, std::size_t m) noexcept
+{
+    using L = utf8_lookup;
+    const __m256i b1h = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(L::byte_1_high)));
+    const __m256i b1l = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(L::byte_1_low)));
+    const __m256i b2h = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(L::byte_2_high)));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    unsigned char before[32];
+    (utf8_previous)(first, p, before, sizeof before);
+    __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(before));
+    __m256i error = _mm256_setzero_si256();
+    utf8_block r{ 0, true };
+    const __m256i front = _mm256_set1_epi8(static_cast<char>(m ? pattern[0] : T()));
+    const __m256i back = _mm256_set1_epi8(static_cast<char>(m ? pattern[m - 1] : T()));
+    for (int i = 0; i != 2; ++i) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+        // The 32 code units ending one, two and three before those of x.
+        const __m256i shifted = _mm256_permute2x128_si256(prev, x, 0x21);
+        const __m256i prev1 = _mm256_alignr_epi8(x, shifted, 15);
+        const __m256i special = _mm256_and_si256(_mm256_and_si256(
+            _mm256_shuffle_epi8(b1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(b1l, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(b2h, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+        const __m256i prev2 = _mm256_alignr_epi8(x, shifted, 14);
+        const __m256i prev3 = _mm256_alignr_epi8(x, shifted, 13);
+        const __m256i must23 = _mm256_or_si256(
+            _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80))),
+            _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80))));
+        const __m256i must23_80 =
+            _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80)));
+        error = _mm256_or_si256(error, _mm256_xor_si256(must23_80, special));
+        prev = x;
+        if (m != 0) {
+            const __m256i y =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i + m - 1));
+            const auto c = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(x, front), _mm256_cmpeq_epi8(y, back))));
+            r.candidates |= std::uint64_t(c) << (32 * i);
+        }
+    }
+    r.valid = _mm256_testz_si256(error, error);
+    return r;
+}
+#endif
+#endif
+
+// Scans the 64 code units at p of the text starting at first: validates
+// them as UTF-8, taking into account the sequences that start before p, and
+// finds the candidate positions of the pattern [pattern, pattern + m); m
+// may be 0, in which case there are none. Requires p + 64 + max(m, 1) - 1 <=
+// last. A sequence that starts in the block and ends after it is checked
+// when the block after it is scanned.
+// The validation uses the lookup algorithm of utf8_lookup with AVX2 or
+// SSSE3, chosen at run time, or else a plain loop.
+template<utf8_code_unit T>
+utf8_block utf8_scan_block(const T* first, const T* p,
+    const T* pattern, std::size_t m, const T* last) noexcept
+{
+#if defined(SIMD_FIND_X86) && defined(__GNUC__)
+    if ((simd_find_has_avx2)())
+        return (utf8_scan_block_avx2)(first, p, pattern, m);
+    if ((simd_find_has_ssse3)())
+        return (utf8_scan_block_ssse3)(first, p, pattern, m);
+#endif
+    return (utf8_scan_block_scalar)(first, p, pattern, m, last);
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class Variant, class Value>
+    class variant_program {
+    public:
+        template<class Children>
+        variant_program(const Variant& root, Children&& children);
+
+        template<class Visitor>
+        Value run(Visitor&& vis) const;
+
+        std::size_t size() const noexcept;
+        std::size_t depth() const noexcept;
+    };
+*/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "invoke.hpp"
+#include "variant_visit.hpp"
+
+// A variant_program evaluates a tree of Variants, such as an expression
+// tree whose alternatives hold their operands as Variants, bottom-up, the
+// way a recursive
+//     Value eval(const Variant& v) {
+//         return variant_visit([](const auto& node) {
+//             ... vis(node, {eval(child)...}) ...
+//         }, v);
+//     }
+// would, but without the recursion: the constructor walks the tree once
+// and flattens it into a post-order list of instructions, each holding the
+// index of the alternative of a node, its number of children and a
+// pointer to the alternative; run() then executes the list on a stack of
+// Values, one instruction after the other.
+// children(node, child), called once per node with its active alternative,
+// must call child(v) with each child Variant v of node, in order. At run
+// time, vis(node, args) is called with the active alternative of each node
+// and a std::span<Value> of the values of its children, in the same order,
+// and returns the value of the node.
+// With GCC and clang, and at most variant_visit_switch_max alternatives,
+// run() dispatches by computed goto, with a copy of the dispatch at the end
+// of each alternative's code, so the cost per node is one indirect jump
+// that the CPU predicts per alternative rather than from a single shared
+// branch; otherwise it dispatches each instruction with variant_dispatch.
+// The program points into the tree, which must outlive it. The values held
+// by the nodes may change between runs; the shape of the tree may not.
+template<class Variant, class Value>
+class variant_program {
+    static_assert(std::is_default_constructible_v<Value> &&
+                  std::is_move_assignable_v<Value>,
+        "Value must be default constructible and move assignable.");
+
+    static constexpr std::size_t size_ = std::variant_size_v<Variant>;
+
+    struct instruction {
+        std::uint32_t op;
+        std::uint32_t arity;
+        const void* node;
+    };
+
+    std::vector<instruction> code_;
+    std::size_t depth_ = 0;
+
+    template<std::size_t I>
+    using node_t = std::remove_cvref_t<decltype(variant_get<I>(std::declval<const Variant&>()))>;
+
+    template<std::size_t I, class Visitor>
+    static void step_(const instruction& in, Value*& sp, Visitor& vis) {
+        const auto& node = *static_cast<const node_t<I>*>(in.node);
+        sp -= in.arity;
+        Value v = (invoke)(vis, node, std::span<Value>(sp, in.arity));
+        *sp++ = std::move(v);
+    }
+public:
+    template<class Children>
+    variant_program(const Variant& root, Children&& children) {
+        // Each entry is the instruction of a node, and the node if its
+        // children are still to be pushed, or null once they are above it.
+        std::vector<std::pair<instruction, const Variant*>> stack{{{}, std::addressof(root)}};
+        std::vector<const Variant*> kids;
+        std::size_t height = 0;
+        while (!stack.empty()) {
+            auto& [in, var] = stack.back();
+            if (!var) {
+                code_.push_back(in);
+                height = height - in.arity + 1;
+                depth_ = std::max(depth_, height);
+                stack.pop_back();
+                continue;
+            }
+            kids.clear();
+            (variant_dispatch<size_, void>)(var->index(), [&](auto i) {
+                const auto& node = variant_get<i>(*var);
+                (invoke)(children, node,
+                    [&](const Variant& child) { kids.push_back(std::addressof(child)); });
+                in = {static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(kids.size()),
+                    std::addressof(node)};
+            });
+            var = nullptr;
+            for (auto k = kids.size(); k != 0; --k)
+                stack.push_back({{}, kids[k - 1]});
+        }
+        code_.push_back({static_cast<std::uint32_t>(size_), 0, nullptr});
+    }
+
+    // The number of nodes.
+    std::size_t size() const noexcept { return code_.size() - 1; }
+    // The most values on the stack during a run.
+    std::size_t depth() const noexcept { return depth_; }
+
+    template<class Visitor>
+    Value run(Visitor&& vis) const {
+        std::vector<Value> stack(depth_);
+        Value* sp = stack.data();
+        const instruction* ip = code_.data();
+#if defined(__GNUC__)
+        // Label addresses and computed gotos are GNU extensions.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+        if constexpr (size_ <= variant_visit_switch_max) {
+#define VARIANT_PROGRAM_LABEL(I) (I < size_ ? &&op##I : &&done),
+            static void* const labels[] = {
+                VARIANT_PROGRAM_LABEL(0) VARIANT_PROGRAM_LABEL(1) VARIANT_PROGRAM_LABEL(2)
+                VARIANT_PROGRAM_LABEL(3) VARIANT_PROGRAM_LABEL(4) VARIANT_PROGRAM_LABEL(5)
+                VARIANT_PROGRAM_LABEL(6) VARIANT_PROGRAM_LABEL(7) VARIANT_PROGRAM_LABEL(8)
+                VARIANT_PROGRAM_LABEL(9) VARIANT_PROGRAM_LABEL(10) VARIANT_PROGRAM_LABEL(11)
+                VARIANT_PROGRAM_LABEL(12) VARIANT_PROGRAM_LABEL(13) VARIANT_PROGRAM_LABEL(14)
+                VARIANT_PROGRAM_LABEL(15) &&done
+            };
+#undef VARIANT_PROGRAM_LABEL
+#define VARIANT_PROGRAM_OP(I) \
+        op##I: \
+            if constexpr (I < size_) { \
+                (step_<I>)(*ip, sp, vis); \
+                goto *labels[(++ip)->op]; \
+            } else \
+                __builtin_unreachable();
+            goto *labels[ip->op];
+            VARIANT_PROGRAM_OP(0) VARIANT_PROGRAM_OP(1) VARIANT_PROGRAM_OP(2)
+            VARIANT_PROGRAM_OP(3) VARIANT_PROGRAM_OP(4) VARIANT_PROGRAM_OP(5)
+            VARIANT_PROGRAM_OP(6) VARIANT_PROGRAM_OP(7) VARIANT_PROGRAM_OP(8)
+            VARIANT_PROGRAM_OP(9) VARIANT_PROGRAM_OP(10) VARIANT_PROGRAM_OP(11)
+            VARIANT_PROGRAM_OP(12) VARIANT_PROGRAM_OP(13) VARIANT_PROGRAM_OP(14)
+            VARIANT_PROGRAM_OP(15)
+#undef VARIANT_PROGRAM_OP
+        done:
+            return std::move(stack[0]);
+        }
+#pragma GCC diagnostic pop
+#endif
+        for (; ip->op != size_; ++ip)
+            (variant_dispatch<size_, void>)(ip->op, [&](auto i) {
+                (step_<i>)(*ip, sp, vis);
+            });
+        return std::move(stack[0]);
+    }
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+/*
+    synopsis
+
+    template<class... Ts>
+    class variant_vector {
+    public:
+        using variant_type = std::variant<Ts...>;
+        template<class T>
+        static constexpr std::size_t index_of = meta_index_of<T, Ts...>::value;
+
+        variant_vector() = default;
+
+        template<class T, class... Args>
+        T& emplace(Args&&... args);
+        template<class T>
+        std::remove_cvref_t<T>& push_back(T&& v);
+        template<class Variant>
+        void push_back_variant(Variant&& var);
+
+        template<class T>
+        std::span<T> segment() noexcept;
+        template<class T>
+        std::span<const T> segment() const noexcept;
+        template<std::size_t I>
+        std::span<alternative_t<I>> segment() noexcept;
+        template<std::size_t I>
+        std::span<const alternative_t<I>> segment() const noexcept;
+
+        template<class T>
+        std::size_t count() const noexcept;
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+
+        template<class T>
+        void reserve(std::size_t n);
+        void clear() noexcept;
+        void shrink_to_fit();
+
+        template<class Visitor>
+        void visit(Visitor&& vis);
+        template<class Visitor>
+        void visit(Visitor&& vis) const;
+    };
+
+    template<class Visitor, class... Ts>
+    void variant_visit_range(Visitor&& vis, variant_vector<Ts...>& v);
+    template<class Visitor, class... Ts>
+    void variant_visit_range(Visitor&& vis, const variant_vector<Ts...>& v);
+*/
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "invoke.hpp"
+#include "meta_index_of.hpp"
+#include "variant_visit.hpp"
+
+template<class T, class... Ts>
+inline constexpr std::size_t variant_vector_count =
+    (std::size_t(std::is_same_v<T, Ts>) + ...);
+
+// A variant_vector holds values of the types Ts... like a
+// std::vector<std::variant<Ts...>>, but in one std::vector per type, the
+// segment of the type, which meta_index_of<T, Ts...> selects. Each element
+// takes the size of its own type instead of that of the largest type plus
+// an index, and elements of the same type are contiguous, so a visit of all
+// elements, segment by segment, dispatches once per type instead of once
+// per element and reads each segment linearly.
+// The order in which values of different types were inserted is not kept:
+// visit() goes through the segments in the order of Ts..., and the
+// elements of each segment in insertion order. As with std::vector,
+// inserting into a segment invalidates the references into that segment.
+// The types must be distinct object types.
+template<class... Ts>
+class variant_vector {
+    static_assert(sizeof...(Ts) != 0, "variant_vector needs at least one type.");
+    static_assert((std::is_object_v<Ts> && ...), "Ts must be object types.");
+    static_assert((!std::is_const_v<Ts> && ...), "Ts cannot be const.");
+    static_assert(((variant_vector_count<Ts, Ts...> == 1) && ...),
+        "Ts must be distinct.");
+
+    std::tuple<std::vector<Ts>...> segments_;
+
+    template<class T>
+    static constexpr bool holds_ = (std::is_same_v<T, Ts> || ...);
+public:
+    using variant_type = std::variant<Ts...>;
+    template<std::size_t I>
+    using alternative_t = std::variant_alternative_t<I, variant_type>;
+    template<class T>
+    static constexpr std::size_t index_of = meta_index_of<T, Ts...>::value;
+
+    variant_vector() = default;
+
+    template<class T, class... Args>
+    requires holds_<T>
+    T& emplace(Args&&... args) {
+        return std::get<index_of<T>>(segments_).emplace_back(
+            static_cast<Args&&>(args)...);
+    }
+
+    template<class T>
+    requires holds_<std::remove_cvref_t<T>>
+    std::remove_cvref_t<T>& push_back(T&& v) {
+        return emplace<std::remove_cvref_t<T>>(static_cast<T&&>(v));
+    }
+
+    // Appends the active alternative of var to its segment.
+    template<class Variant>
+    requires std::is_same_v<std::remove_cvref_t<Variant>, variant_type>
+    void push_back_variant(Variant&& var) {
+        (variant_dispatch<sizeof...(Ts), void>)(var.index(), [&](auto i) {
+            std::get<i>(segments_).push_back(std::get<i>(static_cast<Variant&&>(var)));
+        });
+    }
+
+    template<class T>
+    requires holds_<T>
+    std::span<T> segment() noexcept { return std::get<index_of<T>>(segments_); }
+    template<class T>
+    requires holds_<T>
+    std::span<const T> segment() const noexcept { return std::get<index_of<T>>(segments_); }
+    template<std::size_t I>
+    requires (I < sizeof...(Ts))
+    std::span<alternative_t<I>> segment() noexcept { return std::get<I>(segments_); }
+    template<std::size_t I>
+    requires (I < sizeof...(Ts))
+    std::span<const alternative_t<I>> segment() const noexcept {
+        return std::get<I>(segments_);
+    }
+
+    template<class T>
+    requires holds_<T>
+    std::size_t count() const noexcept { return std::get<index_of<T>>(segments_).size(); }
+    std::size_t size() const noexcept {
+        return std::apply([](const auto&... s) { return (s.size() + ...); }, segments_);
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    template<class T>
+    requires holds_<T>
+    void reserve(std::size_t n) { std::get<index_of<T>>(segments_).reserve(n); }
+    void clear() noexcept { std::apply([](auto&... s) { (s.clear(), ...); }, segments_); }
+    void shrink_to_fit() { std::apply([](auto&... s) { (s.shrink_to_fit(), ...); }, segments_); }
+
+    // Calls vis with each element, as by variant_visit on a variant holding
+    // it: segment by segment, in the order of Ts..., with the results
+    // discarded.
+    template<class Visitor>
+    void visit(Visitor&& vis) {
+        std::apply([&](auto&... s) {
+            ([&] { for (auto& x : s) (invoke)(vis, x); }(), ...);
+        }, segments_);
+    }
+    template<class Visitor>
+    void visit(Visitor&& vis) const {
+        std::apply([&](const auto&... s) {
+            ([&] { for (const auto& x : s) (invoke)(vis, x); }(), ...);
+        }, segments_);
+    }
+};
+
+// variant_visit_range on a variant_vector visits it segment by segment, see
+// variant_vector::visit.
+template<class Visitor, class... Ts>
+void variant_visit_range(Visitor&& vis, variant_vector<Ts...>& v) {
+    v.visit(static_cast<Visitor&&>(vis));
+}
+template<class Visitor, class... Ts>
+void variant_visit_range(Visitor&& vis, const variant_vector<Ts...>& v) {
+    v.visit(static_cast<Visitor&&>(vis));
+}
@@ -1,68 +1,165 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <variant>
 #include <type_traits>
 #include <utility>
 
 #include "invoke.hpp"
 
+// variant_visit reads the alternatives of a variant with variant_get<I>,
+// which is also looked up by argument-dependent lookup, so that variant
+// types other than std::variant can be visited by declaring variant_get
+// for them, along with a specialization of std::variant_size and a member
+// index() that returns std::variant_npos when valueless; see
+// compact_variant.
+template<std::size_t I, class Variant>
+constexpr auto variant_get(Variant&& var)
+    -> decltype(std::get<I>(static_cast<Variant&&>(var)))
+{
+    return std::get<I>(static_cast<Variant&&>(var));
+}
+
+// Tells the compiler that var holds its Ith alternative, so that the check
+// in variant_get<I>, already made by the dispatch, is dropped.
+template<std::size_t I, class Variant>
+constexpr void variant_visit_assume(const Variant& var) noexcept {
+#if defined(__GNUC__)
+    if (var.index() != I)
+        __builtin_unreachable();
+#endif
+}
+
+template<class R, std::size_t I, class F>
+constexpr R variant_dispatch_alt(F& f) {
+    return f(std::integral_constant<std::size_t, I>{});
+}
+
+template<class R, class F, class Is>
+struct variant_dispatch_table;
+
+template<class R, class F, std::size_t... Is>
+struct variant_dispatch_table<R, F, std::index_sequence<Is...>> {
+    static constexpr R (*value[])(F&) = { &variant_dispatch_alt<R, Is, F>... };
+};
+
+// Variants with at most this many alternatives are dispatched by a switch,
+// which the compiler lowers to a jump table and through which it can
+// inline the visitor; larger ones by an indirect call through a constant
+// table of function pointers. Either way the cost of a visit does not
+// depend on the active index.
+inline constexpr std::size_t variant_visit_switch_max = 16;
+
+// Returns f(std::integral_constant<std::size_t, index>{}), which must be of
+// type R, or throws std::bad_variant_access if index is not less than N.
+template<std::size_t N, class R, class F>
+constexpr R variant_dispatch(std::size_t index, F&& f) {
+    if constexpr (N <= variant_visit_switch_max) {
+#define VARIANT_VISIT_CASE(I) \
+        case I: \
+            if constexpr (I < N) \
+                return f(std::integral_constant<std::size_t, I>{}); \
+            else \
+                break;
+        switch (index) {
+            VARIANT_VISIT_CASE(0) VARIANT_VISIT_CASE(1) VARIANT_VISIT_CASE(2)
+            VARIANT_VISIT_CASE(3) VARIANT_VISIT_CASE(4) VARIANT_VISIT_CASE(5)
+            VARIANT_VISIT_CASE(6) VARIANT_VISIT_CASE(7) VARIANT_VISIT_CASE(8)
+            VARIANT_VISIT_CASE(9) VARIANT_VISIT_CASE(10) VARIANT_VISIT_CASE(11)
+            VARIANT_VISIT_CASE(12) VARIANT_VISIT_CASE(13) VARIANT_VISIT_CASE(14)
+            VARIANT_VISIT_CASE(15)
+        }
+#undef VARIANT_VISIT_CASE
+        throw std::bad_variant_access();
+    } else {
+        if (index >= N)
+            throw std::bad_variant_access();
+        return variant_dispatch_table<R, std::remove_reference_t<F>,
+            std::make_index_sequence<N>>::value[index](f);
+    }
+}
+
 template<class Visitor, class Variant>
 constexpr decltype(auto) variant_visit(Visitor&& vis, Variant&& var) {
     constexpr auto size = std::variant_size_v<std::decay_t<Variant>>;
     using R = std::invoke_result_t<Visitor,
-        decltype(std::get<0>(std::declval<Variant>()))>;
-    auto f = [&vis, &var, index = var.index()](auto&& rec, auto i) -> R {
-        // [[assert: &rec == &f]];
-        static_assert(0 <= i && i <= size);
-        if constexpr (i == size)
-            throw std::bad_variant_access();
-        else {
-            static_assert(std::is_same_v<R, std::invoke_result_t<Visitor,
-                decltype(std::get<i>(std::declval<Variant>()))>>,
-                "visitor must return the same type for all alternatives!");
-            if (i == index)
-                return (invoke)(static_cast<Visitor&&>(vis),
-                    std::get<i>(static_cast<Variant&&>(var)));
-            else
-                return rec(rec, std::integral_constant<std::size_t, i + 1>{});
-        }
-    };
-    return f(f, std::integral_constant<std::size_t, 0>{});
+        decltype(variant_get<0>(std::declval<Variant>()))>;
+    return (variant_dispatch<size, R>)(var.index(), [&](auto i) -> R {
+        static_assert(std::is_same_v<R, std::invoke_result_t<Visitor,
+            decltype(variant_get<i>(std::declval<Variant>()))>>,
+            "visitor must return the same type for all alternatives!");
+        (variant_visit_assume<i>)(var);
+        return (invoke)(static_cast<Visitor&&>(vis),
+            variant_get<i>(static_cast<Variant&&>(var)));
+    });
 }
 
-template<class T, std::size_t> struct wrapper { T elem; };
-template<class... Args> struct tuple : Args... {};
+// The dispatch table of a visit of several variants, indexed by the
+// combined index of their alternatives in row-major order, i.e.
+// ((i0 * n1 + i1) * n2 + i2) ... where nj is the size of the jth variant.
+// Each entry passes the active alternatives straight to the visitor.
+template<class R, class Visitor, class... Variants>
+struct variant_visit_flat_table {
+    static constexpr std::size_t sizes[] = {
+        std::variant_size_v<std::decay_t<Variants>>...
+    };
+    static constexpr std::size_t count =
+        (std::variant_size_v<std::decay_t<Variants>> * ...);
 
-template<class I, class Visitor, class... Ts, std::size_t... Is>
-constexpr decltype(auto) visit_impl(I, Visitor&& vis,
-    tuple<wrapper<Ts, Is>...> tpl)
-{
-    return static_cast<Visitor&&>(vis)(
-        static_cast<wrapper<Ts, Is>&>(tpl).elem...);
-}
+    static constexpr std::size_t stride(std::size_t j) {
+        std::size_t s = 1;
+        for (++j; j != sizeof...(Variants); ++j)
+            s *= sizes[j];
+        return s;
+    }
 
-template<class I, class Visitor, class... Ts, std::size_t... Is,
-    class Variant, class... Variants>
-constexpr decltype(auto) visit_impl(I, Visitor&& vis,
-    tuple<wrapper<Ts, Is>...> tpl, Variant&& var, Variants&&... vars)
-{
-    auto f = [&vis, &tpl, &vars...](auto&& cur) -> decltype(auto) {
-        using T = decltype(cur);
-        return (visit_impl)(std::integral_constant<std::size_t, I::value + 1>{},
-            static_cast<Visitor&&>(vis),
-            tuple<wrapper<Ts, Is>..., wrapper<T, I::value>>{
-                static_cast<wrapper<Ts, Is>&>(tpl)..., { static_cast<T>(cur) }
-            },
-            static_cast<Variants&&>(vars)...);
-    };
-    return (variant_visit)(f, static_cast<Variant&&>(var));
+    template<std::size_t... Is>
+    static constexpr R alt(Visitor&& vis, Variants&&... vars) {
+        static_assert(std::is_same_v<R, std::invoke_result_t<Visitor,
+            decltype(variant_get<Is>(std::declval<Variants>()))...>>,
+            "visitor must return the same type for all alternatives!");
+        ((variant_visit_assume<Is>)(vars), ...);
+        return (invoke)(static_cast<Visitor&&>(vis),
+            variant_get<Is>(static_cast<Variants&&>(vars))...);
+    }
+
+    template<std::size_t K, std::size_t... Js>
+    static constexpr auto entry(std::index_sequence<Js...>) {
+        return &alt<K / stride(Js) % sizes[Js]...>;
+    }
+
+    template<std::size_t... Ks>
+    static constexpr auto make(std::index_sequence<Ks...>) {
+        return std::array<R (*)(Visitor&&, Variants&&...), count>{{
+            (entry<Ks>)(std::index_sequence_for<Variants...>{})...
+        }};
+    }
+
+    static constexpr auto value = (make)(std::make_index_sequence<count>{});
+};
+
+template<class Variant>
+constexpr std::size_t variant_visit_combine(std::size_t index, const Variant& var) {
+    constexpr auto size = std::variant_size_v<std::decay_t<Variant>>;
+    const std::size_t i = var.index();
+    if (i >= size)
+        throw std::bad_variant_access();
+    return index * size + i;
 }
 
+// Visiting several variants makes one indirect call, through a table with
+// an entry for every combination of their alternatives.
 template<class Visitor, class Variant, class... Variants>
 constexpr decltype(auto) variant_visit(Visitor&& vis, Variant&& var,
     Variants&&... vars)
 {
-    return (visit_impl)(std::integral_constant<std::size_t, 0>{}, 
-        static_cast<Visitor&&>(vis), tuple<>{},
+    using R = std::invoke_result_t<Visitor,
+        decltype(variant_get<0>(std::declval<Variant>())),
+        decltype(variant_get<0>(std::declval<Variants>()))...>;
+    using table = variant_visit_flat_table<R, Visitor, Variant, Variants...>;
+    std::size_t index = (variant_visit_combine)(0, var);
+    ((index = (variant_visit_combine)(index, vars)), ...);
+    return table::value[index](static_cast<Visitor&&>(vis),
         static_cast<Variant&&>(var), static_cast<Variants&&>(vars)...);
 }
@@ -0,0 +1,228 @@
+#pragma once
+
+/*
+    synopsis
+
+    class variant_visit_site {
+    public:
+        variant_visit_site(const variant_visit_site&) = delete;
+        variant_visit_site& operator=(const variant_visit_site&) = delete;
+
+        const char* name() const noexcept;
+        const std::source_location& where() const noexcept;
+        std::size_t size() const noexcept;
+        std::uint64_t count(std::size_t i) const noexcept;
+        std::vector<std::size_t> hot_order() const;
+        void reset() noexcept;
+
+        template<class F>
+        static void for_each(F f);
+    };
+
+    template<class Variant>
+    class variant_visit_profile : public variant_visit_site {
+    public:
+        explicit variant_visit_profile(const char* name = "",
+            std::source_location where = std::source_location::current());
+
+        void hit(std::size_t i) noexcept;
+    };
+
+    void variant_visit_profile_dump(std::ostream& os);
+
+    template<class Visitor, class Variant, class Profile>
+    constexpr decltype(auto) variant_visit_profiled(Profile& site, Visitor&& vis, Variant&& var);
+
+    template<std::size_t... Hot, class Visitor, class Variant>
+    constexpr decltype(auto) variant_visit_likely(Visitor&& vis, Variant&& var);
+*/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <source_location>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "invoke.hpp"
+#include "variant_visit.hpp"
+
+// A variant_visit_site counts, for one visit site, how many visits found
+// each alternative active. The counting is opt-in: variant_visit_profiled
+// records a hit only if VARIANT_VISIT_PROFILE is defined, and otherwise
+// costs nothing more than variant_visit, so profiled sites can stay in the
+// code. All live sites are listed by for_each, e.g. for
+// variant_visit_profile_dump. The counts are relaxed atomics, so sites may
+// be hit from several threads.
+class variant_visit_site {
+    const char* name_;
+    std::source_location where_;
+    std::atomic<std::uint64_t>* counts_;
+    std::size_t size_;
+    variant_visit_site* prev_ = nullptr;
+    variant_visit_site* next_ = nullptr;
+
+    struct registry {
+        std::mutex mutex;
+        variant_visit_site* head = nullptr;
+    };
+    static registry& registry_() {
+        static registry r;
+        return r;
+    }
+protected:
+    variant_visit_site(const char* name, std::source_location where,
+                       std::atomic<std::uint64_t>* counts, std::size_t size)
+        : name_(name), where_(where), counts_(counts), size_(size)
+    {
+        auto& r = registry_();
+        std::lock_guard lock(r.mutex);
+        next_ = r.head;
+        if (next_)
+            next_->prev_ = this;
+        r.head = this;
+    }
+    ~variant_visit_site() {
+        auto& r = registry_();
+        std::lock_guard lock(r.mutex);
+        (prev_ ? prev_->next_ : r.head) = next_;
+        if (next_)
+            next_->prev_ = prev_;
+    }
+public:
+    variant_visit_site(const variant_visit_site&) = delete;
+    variant_visit_site& operator=(const variant_visit_site&) = delete;
+
+    const char* name() const noexcept { return name_; }
+    const std::source_location& where() const noexcept { return where_; }
+    std::size_t size() const noexcept { return size_; }
+    std::uint64_t count(std::size_t i) const noexcept {
+        return counts_[i].load(std::memory_order_relaxed);
+    }
+
+    // The alternatives with at least one hit, from the most to the least
+    // often active.
+    std::vector<std::size_t> hot_order() const {
+        std::vector<std::size_t> order(size_);
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::stable_sort(order.begin(), order.end(),
+            [this](std::size_t a, std::size_t b) { return count(a) > count(b); });
+        order.erase(std::find_if(order.begin(), order.end(),
+            [this](std::size_t i) { return count(i) == 0; }), order.end());
+        return order;
+    }
+
+    void reset() noexcept {
+        for (std::size_t i = 0; i != size_; ++i)
+            counts_[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Calls f(const variant_visit_site&) for each live site, most recently
+    // constructed first; sites must not be constructed or destroyed by f.
+    template<class F>
+    static void for_each(F f) {
+        auto& r = registry_();
+        std::lock_guard lock(r.mutex);
+        for (auto site = r.head; site; site = site->next_)
+            f(std::as_const(*site));
+    }
+};
+
+// The site of the visits of a Variant, usually a function-local static:
+//     static variant_visit_profile<message> site("dispatch");
+//     variant_visit_profiled(site, handler, msg);
+template<class Variant>
+class variant_visit_profile : public variant_visit_site {
+    static constexpr auto size_ = std::variant_size_v<Variant>;
+
+    std::array<std::atomic<std::uint64_t>, size_> counts_{};
+public:
+    explicit variant_visit_profile(const char* name = "",
+        std::source_location where = std::source_location::current())
+        : variant_visit_site(name, where, counts_.data(), size_) {}
+
+    void hit(std::size_t i) noexcept {
+        if (i < size_)
+            counts_[i].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Writes the counts of every site, one line per site, each followed by a
+// variant_visit_likely hint naming the fewest alternatives that account
+// for at least 90% of its visits, at most three.
+inline void variant_visit_profile_dump(std::ostream& os) {
+    variant_visit_site::for_each([&os](const variant_visit_site& site) {
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i != site.size(); ++i)
+            total += site.count(i);
+        os << site.where().file_name() << ':' << site.where().line();
+        if (*site.name())
+            os << ' ' << site.name();
+        os << ": " << total << " visits;";
+        const auto order = site.hot_order();
+        for (auto i : order)
+            os << ' ' << i << '=' << site.count(i);
+        os << '\n';
+        if (total == 0)
+            return;
+        os << "    hint: variant_visit_likely<";
+        std::uint64_t covered = 0;
+        for (std::size_t k = 0; k != order.size() && k != 3 && covered * 10 < total * 9; ++k) {
+            os << (k ? ", " : "") << order[k];
+            covered += site.count(order[k]);
+        }
+        os << ">\n";
+    });
+}
+
+template<class Visitor, class Variant, class Profile>
+requires std::is_base_of_v<variant_visit_site, Profile>
+constexpr decltype(auto) variant_visit_profiled(Profile& site, Visitor&& vis, Variant&& var) {
+#ifdef VARIANT_VISIT_PROFILE
+    site.hit(var.index());
+#else
+    static_cast<void>(site);
+#endif
+    return (variant_visit)(static_cast<Visitor&&>(vis), static_cast<Variant&&>(var));
+}
+
+template<class R, class Visitor, class Variant>
+constexpr R variant_visit_hot(std::size_t, Visitor&& vis, Variant&& var) {
+    return (variant_visit)(static_cast<Visitor&&>(vis), static_cast<Variant&&>(var));
+}
+
+template<class R, std::size_t I, std::size_t... Rest, class Visitor, class Variant>
+constexpr R variant_visit_hot(std::size_t index, Visitor&& vis, Variant&& var) {
+    static_assert(I < std::variant_size_v<std::decay_t<Variant>>,
+        "hot alternative out of range");
+    static_assert(std::is_same_v<R, std::invoke_result_t<Visitor,
+        decltype(variant_get<I>(std::declval<Variant>()))>>,
+        "visitor must return the same type for all alternatives!");
+    if (index == I) [[likely]] {
+        (variant_visit_assume<I>)(var);
+        return (invoke)(static_cast<Visitor&&>(vis),
+            variant_get<I>(static_cast<Variant&&>(var)));
+    }
+    return (variant_visit_hot<R, Rest...>)(index,
+        static_cast<Visitor&&>(vis), static_cast<Variant&&>(var));
+}
+
+// variant_visit_likely<Hot...>(vis, var) is variant_visit(vis, var), but
+// first tests whether the active alternative is one of Hot..., in that
+// order, each test hinted as likely, so that a visit of a hot alternative
+// is a predictable compare and a direct, inlinable call; the other
+// alternatives fall back to the full dispatch of variant_visit. Hot...
+// is usually taken from the hint of variant_visit_profile_dump.
+template<std::size_t... Hot, class Visitor, class Variant>
+constexpr decltype(auto) variant_visit_likely(Visitor&& vis, Variant&& var) {
+    using R = std::invoke_result_t<Visitor,
+        decltype(variant_get<0>(std::declval<Variant>()))>;
+    return (variant_visit_hot<R, Hot...>)(var.index(),
+        static_cast<Visitor&&>(vis), static_cast<Variant&&>(var));
+}
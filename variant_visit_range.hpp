@@ -0,0 +1,151 @@
+#pragma once
+
+/*
+    synopsis
+
+    struct variant_visit_ordered_t {
+        explicit variant_visit_ordered_t() = default;
+    };
+    inline constexpr variant_visit_ordered_t variant_visit_ordered{};
+
+    struct variant_visit_unordered_t {
+        explicit variant_visit_unordered_t() = default;
+    };
+    inline constexpr variant_visit_unordered_t variant_visit_unordered{};
+
+    template<class Visitor, std::ranges::input_range R>
+    constexpr void variant_visit_range(Visitor&& vis, R&& r);
+    template<class Visitor, std::ranges::input_range R>
+    constexpr void variant_visit_range(variant_visit_ordered_t, Visitor&& vis, R&& r);
+    template<class Visitor, std::ranges::forward_range R>
+    void variant_visit_range(variant_visit_unordered_t, Visitor&& vis, R&& r);
+*/
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "invoke.hpp"
+#include "variant_visit.hpp"
+
+struct variant_visit_ordered_t {
+    explicit variant_visit_ordered_t() = default;
+};
+inline constexpr variant_visit_ordered_t variant_visit_ordered{};
+
+struct variant_visit_unordered_t {
+    explicit variant_visit_unordered_t() = default;
+};
+inline constexpr variant_visit_unordered_t variant_visit_unordered{};
+
+template<std::ranges::input_range R>
+using variant_range_t = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+
+// variant_visit_range(vis, r) calls vis with the active alternative of each
+// variant in r, like
+//     for (auto&& v : r) variant_visit(vis, v);
+// with the results discarded, but dispatches once per run of elements with
+// the same active alternative: each run is visited by a loop specialized for
+// that alternative, with no dispatch in it, which the compiler can unroll
+// or vectorize. The calls are made in the order of r. This pays off when
+// equal alternatives come in runs, e.g. in sorted or bursty data.
+// With variant_visit_unordered, each chunk of up to variant_visit_chunk
+// elements is grouped by alternative, by counting sort of their positions
+// in the chunk, and each group is then visited by one specialized loop: the
+// chunks are visited in the order of r, and within a chunk the groups in the
+// order of the alternatives and the elements of a group in the order of r.
+// This replaces a dispatch per element by two passes over the chunk's
+// indices, and pays off when alternatives are mixed at random.
+// A valueless element throws std::bad_variant_access: in order, when it is
+// reached; unordered, before any element of its chunk is visited.
+template<class Visitor, std::ranges::input_range R>
+constexpr void variant_visit_range(variant_visit_ordered_t, Visitor&& vis, R&& r) {
+    using V = variant_range_t<R>;
+    constexpr auto size = std::variant_size_v<V>;
+    auto first = std::ranges::begin(r);
+    const auto last = std::ranges::end(r);
+    while (first != last) {
+        const std::size_t index = (*first).index();
+        (variant_dispatch<size, void>)(index, [&](auto i) {
+            do {
+                auto&& var = *first;
+                (variant_visit_assume<i>)(var);
+                (invoke)(vis, variant_get<i>(static_cast<decltype(var)&&>(var)));
+            } while (++first != last && (*first).index() == i);
+        });
+    }
+}
+
+template<class Visitor, std::ranges::input_range R>
+constexpr void variant_visit_range(Visitor&& vis, R&& r) {
+    (variant_visit_range)(variant_visit_ordered, static_cast<Visitor&&>(vis),
+        static_cast<R&&>(r));
+}
+
+// The number of elements grouped at a time by the unordered
+// variant_visit_range, small enough for the elements and the group buffer
+// to stay in the L1 cache between the grouping and the visit. The elements
+// of a random access range are reached from the start of their chunk; those
+// of other ranges through a copy of their iterator, so the chunk is made
+// smaller as the iterator gets larger than a pointer.
+inline constexpr std::size_t variant_visit_chunk = 1024;
+
+template<class Visitor, std::ranges::forward_range R>
+void variant_visit_range(variant_visit_unordered_t, Visitor&& vis, R&& r) {
+    using V = variant_range_t<R>;
+    using I = std::ranges::iterator_t<R>;
+    constexpr auto size = std::variant_size_v<V>;
+    constexpr bool random = std::ranges::random_access_range<R>;
+    constexpr std::size_t chunk = random ? variant_visit_chunk :
+        std::max<std::size_t>(1, variant_visit_chunk * sizeof(void*) / sizeof(I));
+    static_assert(size <= 0x10000 && chunk <= 0x10000,
+        "Indices and positions must fit in 16 bits.");
+    std::array<std::uint16_t, chunk> indices;
+    std::array<std::uint16_t, chunk> group;
+    std::conditional_t<random, std::ranges::dangling, std::array<I, chunk>> its;
+    auto first = std::ranges::begin(r);
+    const auto last = std::ranges::end(r);
+    while (first != last) {
+        const I start = first;
+        // Four interleaved histograms, so that a run of equal indices does
+        // not make each increment wait for the previous one.
+        std::array<std::array<std::size_t, size + 1>, 4> counts{};
+        std::size_t n = 0;
+        for (; n != chunk && first != last; ++first, ++n) {
+            const std::size_t index = (*first).index();
+            if (index >= size)
+                throw std::bad_variant_access();
+            if constexpr (!random)
+                its[n] = first;
+            indices[n] = static_cast<std::uint16_t>(index);
+            ++counts[n % 4][index + 1];
+        }
+        std::array<std::size_t, size + 1> offsets{};
+        for (std::size_t i = 1; i != size + 1; ++i)
+            offsets[i] = offsets[i - 1] +
+                counts[0][i] + counts[1][i] + counts[2][i] + counts[3][i];
+        auto next = offsets;
+        for (std::size_t k = 0; k != n; ++k)
+            group[next[indices[k]]++] = static_cast<std::uint16_t>(k);
+        const auto element = [&](std::size_t k) -> decltype(auto) {
+            if constexpr (random)
+                return *(start + static_cast<std::iter_difference_t<I>>(group[k]));
+            else
+                return *its[group[k]];
+        };
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ([&] {
+                for (auto k = offsets[Is]; k != offsets[Is + 1]; ++k) {
+                    auto&& var = element(k);
+                    (variant_visit_assume<Is>)(var);
+                    (invoke)(vis, variant_get<Is>(static_cast<decltype(var)&&>(var)));
+                }
+            }(), ...);
+        }(std::make_index_sequence<size>{});
+    }
+}